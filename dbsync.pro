@@ -3,7 +3,7 @@
 # ------------------------------------------------------
 
 greaterThan(QT_MAJOR_VERSION, 5): 
-QT += sql core
+QT += sql core network
 
 TEMPLATE = app
 TARGET  = DbSync
@@ -27,6 +27,12 @@ contains(DEFINES, CRASH_ON) {
   TARGET  = DbSyncEx  
 }
 
+contains(DEFINES, LIBPQ_ON) {
+  message( "* LIBPQ_ON Compilation: COPY of the staging table *" )
+  win32: LIBS += -llibpq
+  else:  LIBS += -lpq
+}
+
 
 UI_DIR         = tmp
 QRC_DIR        = tmp
@@ -42,18 +42,55 @@ BOOL WINAPI CrashCallback(LPVOID /*lpvState*/)
 #include <QSqlRecord>
 #include <QVariant>
 #include <QSqlField>
+#include <QSql>
 #include <QTime>
 #include <QDir>
+#include <QFileInfo>
 #include <QThread>
 #include <QCryptographicHash>
 #include <QSettings>
 #include <QTextCodec>
 #include <locale.h>
 #include <QTextStream>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QMap>
+#include <QSqlDriver>
+
+#ifdef LIBPQ_ON
+#include <libpq-fe.h>		// COPY of the staging table, pipeline mode, asynchronous reading
+ #ifdef WIN32
+ #include <winsock2.h>		// WSAPoll
+ #else
+ #include <poll.h>
+ #endif
+#endif
 
 #include "lin.h"
 #include "vers.h"
+#include "sha3.h"
+
+
+typedef struct _throttle
+{
+	double			maxRate	= 0;	// rows per second (0 - w/o limit)
+	int				maxLat	= 0;	// statement latency, msec (0 - w/o limit)
+	double			maxLag	= 0;	// replication lag, sec (0 - w/o control)
+	QString			lagSql	= "";	// query of the lag (sec)
 
+	QElapsedTimer	timer;
+	qint64			rows	= 0;	// changed rows
+	double			delay	= 0;	// adaptive pause between statements, msec
+	qint64			nextLag	= 0;	// time of the next lag query, msec
+	qint64			waitMs	= 0;	// total pauses
+
+} throttle;
 
 typedef struct _tabcol
 {
@@ -63,22 +100,73 @@ typedef struct _tabcol
 	QString		tab		= "";	// table name
 	QString		where	= "";	// where
 	QStringList	trigg;			// triggers off
+	QString		hashCol	= "";	// stored checksum of the row (trigger, generated column)
+	QString		slot	= "";		// QPSQL: logical replication slot of the source (test_decoding), only the changed keys
 
 	bool		bIgnAll	= false;
 	bool		bIgnIns	= false;
 	bool		bIgnDel	= false;
 	bool		bIgnUpd	= false;
 	bool		bIgnTRG	= false;
+	bool		bTrgSess= false;	// triggers off only for own session (w/o table lock)
 	bool		bAAC	= false;
 	bool		bDebug  = false;
+	bool		bPipe	= false;	// pipelined processing
+	double		sample	= 0;		// sampling: percent of the rows (0 - all rows)
+	QString		joinSrc	= "";		// source table in the destination Db (comparison on the server)
+	int			readRetry=2;		// attempts again for a failed part of the reading
+	bool		bPartitions=false;	// the partitions (the same on both sides) are processed in parallel
+	bool		bExplain=false;		// plans of the generated statements (once per shape) into the log
+	bool		bExplainAn=false;	// QPSQL: explain analyze of insert, update, delete (executed, rolled back)
+	int			verify	= -1;		// rows of the sample for the verification after the changes (-1 - w/o verification)
+	bool		bAsyncRead=false;	// QPSQL: the parts are read by one thread (libpq asynchronous queries)
 
 	bool		bLog	= false;	
 	QString		logData	= "";
 	int			maxQSymb= -1;
 
+	QString		pathJrn	= "";		// journal of the changes
+	QByteArray	identJrn;			// TableFile & databases (for journal)
+	bool		bResume	= false;	// continue the changes of the journal
+	bool		bKeyGuard=false;	// change the row only if the key is the same
+	bool		bSetApply=false;	// apply the changes as one set (staging table)
+	int			asyncBatch=0;		// rows of one transaction in libpq pipeline mode (0 - row by row)
+
+	throttle	thr;				// speed of the changes
+	int			total[4] = { 0, 0, 0, 0 };	// last totals: identical, different, unnecessary, missing
+
 } tabcol;
 
 
+typedef void    (*fnCellEnc)(const QVariant& var, QString& r);			// column data from the database
+typedef bool    (*fnCellCmp)(const QVariant& a, const QVariant& b);		// same column data
+typedef QString (*fnCellLit)(const QVariant& var, int pos);				// column data to form a query
+
+typedef struct _rowcodec
+{
+	QVector<fnCellEnc>	enc;
+	QVector<fnCellCmp>	cmp;
+	QVector<fnCellLit>	lit;
+	int					ColUnsupp = -1;	// index of unsupp.col
+
+} rowcodec;
+
+
+typedef struct _rowkey
+{
+	quint64		k[2] = { 0, 0 };	// 1-2 integer key columns (fast path)
+	QByteArray	b;					// other keys: binary form of the columns
+
+	bool operator == (const _rowkey& r) const { return k[0] == r.k[0] && k[1] == r.k[1] && b == r.b; }
+	bool operator != (const _rowkey& r) const { return !(*this == r); }
+
+} rowkey;
+
+inline uint qHash (const rowkey& r, uint seed = 0)
+{
+	return qHash(r.b, seed) ^ qHash(r.k[0] * 0x9E3779B97F4A7C15ULL + r.k[1], seed);
+}
+
 typedef QList<QVariantList> tabdata;
 typedef struct _linetab
 {
@@ -86,12 +174,35 @@ typedef struct _linetab
 	QStringList	m_nameCol;			// columns name
 	QStringList	m_crcline;			// CRC per row
 	tabdata		m_tabdata;			// all rows of the table in columns
+	rowcodec	m_codec;			// columns functions (by type)
+	QVector<rowkey>	m_keyline;		// key per row
+	QList<int>	m_keyKind;			// kind of key columns (KEY_TEXT, KEY_INT, KEY_BYTES)
 
 	bool		b_Unsuppt = false;	// unsupported columns
 	int			ColUnsupp = -1;		// index of unsupp.col
 
 } linetab;
 
+typedef struct _rowact
+{
+	int				mode = 0;		// SychroDatab mode: 0 - unnecessary (delete), 1 - missing (insert), 2 - different (update)
+	QVariantList	rowS;			// source row (insert, update)
+	QVariantList	rowD;			// destination row (delete, update)
+
+} rowact;
+
+typedef struct _journal
+{
+	QString			path	= "";		// file of the journal
+	QByteArray		ident;				// TableFile & databases
+	QList<int>		typeS, typeD;		// columns type
+	int				Identical = 0;		// identical rows
+	QList<rowact>	acts;				// rows to change
+	QVector<int>	state;				// processed rows (resume)
+	QFile*			pf		= nullptr;
+
+} journal;
+
 
 //-------------------------------------------------------------------------------------------------
 void AddLog (tabcol* ptabcol, QString txt, bool CheckMax=true)	
@@ -103,6 +214,147 @@ void AddLog (tabcol* ptabcol, QString txt, bool CheckMax=true)
 	ptabcol->logData += "\n";
 }
 
+//-------------------------------------------------------------------------------------------------
+// timeline of the run for profiling (--trace): Chrome trace / Perfetto JSON.
+// Spans are recorded from the constructor to the destructor of CTraceSpan, w/o --trace only a flag is checked
+#define TRACE_MAX	1000000		// max spans (the rest is counted only)
+
+typedef struct _traceev
+{
+	const char*	name;
+	QString		arg;			// sql or other text
+	qint64		n;				// rows (-1 - w/o)
+	qint64		ts, dur;		// nsec
+	quint64		tid;
+
+} traceev;
+
+typedef struct _tracelog
+{
+	bool					bOn  = false;
+	QElapsedTimer			timer;
+	QMutex					mtx;
+	QVector<traceev>		ev;
+	QMap<quint64, QString>	thrName;
+	qint64					lost = 0;
+
+} tracelog;
+
+static tracelog g_trace;
+
+//-------------------------------------------------------------------------------------------------
+inline quint64 TraceTid ()
+{
+	return (quint64)(quintptr)QThread::currentThreadId();
+}
+
+//-------------------------------------------------------------------------------------------------
+void TraceAdd (const char* name, const QString& arg, qint64 n, qint64 ts)
+{
+	traceev e;
+	e.name = name;	e.arg = arg;	e.n = n;
+	e.ts   = ts;	e.dur = g_trace.timer.nsecsElapsed() - ts;
+	e.tid  = TraceTid();
+
+	QMutexLocker lock(&g_trace.mtx);
+	if (g_trace.ev.size() >= TRACE_MAX) {
+		g_trace.lost++;
+		return;
+	}
+	g_trace.ev.append(e);
+}
+
+//-------------------------------------------------------------------------------------------------
+void TraceThread (const QString& name)	// name of the current thread on the timeline
+{
+	if (g_trace.bOn == false)
+		return;
+	QMutexLocker lock(&g_trace.mtx);
+	g_trace.thrName[TraceTid()] = name;
+}
+
+//-------------------------------------------------------------------------------------------------
+class CTraceSpan
+{
+public:
+	CTraceSpan (const char* name, const QString& arg = QString(), qint64 rows = -1) : pName(name), n(rows)
+	{
+		if (g_trace.bOn == true) {
+			sArg = arg;
+			ts   = g_trace.timer.nsecsElapsed();
+		}
+	}
+	~CTraceSpan ()
+	{
+		if (ts >= 0)
+			TraceAdd (pName, sArg, n, ts);
+	}
+
+private:
+	const char*	pName;
+	QString		sArg;
+	qint64		ts	= -1;
+public:
+	qint64		n;				// rows (can be set up to the end of the span)
+};
+
+//-------------------------------------------------------------------------------------------------
+QByteArray TraceJson (const QString& txt)	// json string
+{
+	QByteArray u = txt.toUtf8();
+	QByteArray r = "\"";
+	for (int i = 0; i < u.size(); i++) {
+		unsigned char c = (unsigned char)u.at(i);
+		if		(c == '"')	r += "\\\"";
+		else if (c == '\\')	r += "\\\\";
+		else if (c == '\n')	r += "\\n";
+		else if (c < 0x20)	r += QString("\\u%1").arg(c, 4, 16, QChar('0')).toLatin1();
+		else				r += (char)c;
+	}
+	return r + "\"";
+}
+
+//-------------------------------------------------------------------------------------------------
+int TraceSave (QString path)	// chrome://tracing, https://ui.perfetto.dev
+{
+	QFile ff(path);
+	if (ff.open(QFile::WriteOnly) == false) {
+		printf ("Warning ! Trace file isn't created: %s\n", qPrintable(path));
+		return -1;
+	}
+
+	QMutexLocker lock(&g_trace.mtx);
+	ff.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	ff.write("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DbSync\"}}");
+
+	QMap<quint64, int> tid;		// small numbers of the threads
+	for (int k = 0; k < g_trace.ev.size(); k++)
+		if (tid.contains(g_trace.ev.at(k).tid) == false)	tid.insert(g_trace.ev.at(k).tid, tid.size() + 1);
+
+	QMap<quint64, QString>::const_iterator it;
+	for (it = g_trace.thrName.constBegin(); it != g_trace.thrName.constEnd(); ++it)
+		if (tid.contains(it.key()) == true)
+			ff.write(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + QByteArray::number(tid.value(it.key())) +
+					 ",\"args\":{\"name\":" + TraceJson(it.value()) + "}}");
+
+	for (int k = 0; k < g_trace.ev.size(); k++) {
+		const traceev& e = g_trace.ev.at(k);
+		QByteArray r = ",\n{\"name\":" + TraceJson(e.name) + ",\"ph\":\"X\",\"pid\":1,\"tid\":" + QByteArray::number(tid.value(e.tid)) +
+					   ",\"ts\":"  + QByteArray::number(e.ts  / 1000., 'f', 3) +
+					   ",\"dur\":" + QByteArray::number(e.dur / 1000., 'f', 3) + ",\"args\":{";
+		if (e.n >= 0)				r += "\"rows\":" + QByteArray::number(e.n);
+		if (e.arg.isEmpty() == false)	r += QByteArray((e.n >= 0) ? "," : "") + "\"text\":" + TraceJson(e.arg);
+		ff.write(r + "}}");
+	}
+	ff.write("\n]}\n");
+	ff.close();
+
+	printf ("Trace: %s (%d spans", qPrintable(path), g_trace.ev.size());
+	if (g_trace.lost > 0)	printf (", %lld aren't saved", g_trace.lost);
+	printf (")\n");
+	return 0;
+}
+
 //-------------------------------------------------------------------------------------------------
 QString SetVariantStr(int type, const QVariant& var, int pos)	// column data to form a query
 {
@@ -261,6 +513,327 @@ inline QString GetCrc(QVariantList* vlist, QList<int>*	m_typeCol, bool& bUnsuppo
 	return QString::fromLocal8Bit(sha.toHex ());	// -char-
 }
 
+//-------------------------------------------------------------------------------------------------
+// row codec: the functions of the columns are generated from the templates and selected once
+// per table, so the rows are processed without a switch on the column type.
+inline void AppendNum (QString& r, int v, int width)	// zero-padded number (v >= 0)
+{
+	char buf[12]; int n = 0;
+	do { buf[n++] = char('0' + v % 10); v /= 10; } while (v > 0 && n < 12);
+	for (int i = n; i < width; i++)	r += QLatin1Char('0');
+	while (n > 0)					r += QLatin1Char(buf[--n]);
+}
+
+template <int TYPE> struct CCellCodec		// the same data as GetVariantStr / SetVariantStr
+{
+	static void Enc (const QVariant& var, QString& r) {
+		bool bUnsupport = false;
+		r += GetVariantStr(TYPE, var, bUnsupport);
+	}
+	static bool Cmp (const QVariant& a, const QVariant& b) {
+		if (a.isNull() == true || b.isNull() == true)
+			return a.isNull() == b.isNull();
+		bool bUnsupport = false;
+		return GetVariantStr(TYPE, a, bUnsupport) == GetVariantStr(TYPE, b, bUnsupport);
+	}
+	static QString Lit (const QVariant& var, int pos) {
+		return SetVariantStr(TYPE, var, pos);
+	}
+};
+
+template <> inline void CCellCodec<QVariant::DateTime>::Enc (const QVariant& var, QString& r)
+{
+	if (var.isNull()) { r += "null"; return; }
+	QDateTime md = var.toDateTime();
+	QDate d = md.date();
+	QTime t = md.time();
+	if (d.isValid() == false || t.isValid() == false || d.year() < 0 || d.year() > 9999) {
+		bool bUnsupport = false;
+		r += GetVariantStr(QVariant::DateTime, var, bUnsupport);
+		return;
+	}
+	AppendNum(r, d.day(),  2); r += QLatin1Char('.'); AppendNum(r, d.month(),  2); r += QLatin1Char('.'); AppendNum(r, d.year(),   4); r += QLatin1Char(' ');
+	AppendNum(r, t.hour(), 2); r += QLatin1Char(':'); AppendNum(r, t.minute(), 2); r += QLatin1Char(':'); AppendNum(r, t.second(), 2); r += QLatin1Char('.');
+	AppendNum(r, t.msec(), 3);
+}
+template <> inline bool CCellCodec<QVariant::DateTime>::Cmp (const QVariant& a, const QVariant& b)
+{
+	if (a.isNull() == true || b.isNull() == true)	return a.isNull() == b.isNull();
+	return a.toDateTime() == b.toDateTime();
+}
+
+template <> inline void CCellCodec<QVariant::String>::Enc (const QVariant& var, QString& r)
+{
+	if (var.isNull())	r += "null";
+	else				r += var.toString();
+}
+template <> inline bool CCellCodec<QVariant::String>::Cmp (const QVariant& a, const QVariant& b)
+{
+	if (a.isNull() == true || b.isNull() == true)	return a.isNull() == b.isNull();
+	return a.toString() == b.toString();
+}
+
+template <> inline void CCellCodec<QVariant::ByteArray>::Enc (const QVariant& var, QString& r)
+{
+	if (var.isNull())	r += "null";
+	else				r += QString::fromLocal8Bit(var.toByteArray().toHex(':'));	// -char-
+}
+template <> inline bool CCellCodec<QVariant::ByteArray>::Cmp (const QVariant& a, const QVariant& b)
+{
+	if (a.isNull() == true || b.isNull() == true)	return a.isNull() == b.isNull();
+	return a.toByteArray() == b.toByteArray();
+}
+
+template <int TYPE> struct CCellNum : CCellCodec<TYPE>	// numbers: the value of the driver (QSql::NumericalPrecisionPolicy)
+{
+	static void Enc (const QVariant& var, QString& r) {
+		if (var.isNull())	r += "null";
+		else				r += var.toString(); //-V1037
+	}
+	static bool Cmp (const QVariant& a, const QVariant& b) {
+		if (a.isNull() == true || b.isNull() == true)	return a.isNull() == b.isNull();
+		return a.toString() == b.toString();
+	}
+};
+
+template <class CODEC> inline void AddCellCodec (rowcodec* c)
+{
+	c->enc.append(&CODEC::Enc);
+	c->cmp.append(&CODEC::Cmp);
+	c->lit.append(&CODEC::Lit);
+}
+
+//-------------------------------------------------------------------------------------------------
+rowcodec GetRowCodec (const QList<int>& typeCol)	// once per table (w/o rowid - last column)
+{
+	rowcodec c;
+	for (int n = 0; n < typeCol.size() - 1; n++) {
+		switch (typeCol.at(n))
+		{
+		case QVariant::DateTime:	AddCellCodec<CCellCodec<QVariant::DateTime> >	(&c);	break;
+		case QVariant::Date:		AddCellCodec<CCellCodec<QVariant::Date> >		(&c);	break;
+		case QVariant::Time:		AddCellCodec<CCellCodec<QVariant::Time> >		(&c);	break;
+		case QVariant::Double:		AddCellCodec<CCellNum<QVariant::Double> >		(&c);	break;
+		case QVariant::LongLong:	AddCellCodec<CCellNum<QVariant::LongLong> >		(&c);	break;
+		case QVariant::ULongLong:	AddCellCodec<CCellNum<QVariant::ULongLong> >	(&c);	break;
+		case QVariant::UInt:		AddCellCodec<CCellNum<QVariant::UInt> >			(&c);	break;
+		case QVariant::Int:			AddCellCodec<CCellNum<QVariant::Int> >			(&c);	break;
+		case QVariant::String:		AddCellCodec<CCellCodec<QVariant::String> >		(&c);	break;
+		case QVariant::ByteArray:	AddCellCodec<CCellCodec<QVariant::ByteArray> >	(&c);	break;
+		default:
+			AddCellCodec<CCellCodec<QVariant::Invalid> >(&c);
+			if (c.ColUnsupp == -1)
+				c.ColUnsupp = n + 1;
+			break;
+		}
+	}
+	return c;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline void EncodeRow(const QVariantList& vlist, const rowcodec& codec, QString& rowdata)	// row data by the codec (same as GetRows)
+{
+	rowdata.resize(0);	// buffer of the thread
+	for (int i = 0; i < codec.enc.size(); i++) {
+		codec.enc.at(i)(vlist.at(i), rowdata);
+		rowdata += "; ";
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+inline QString GetCrc(const QVariantList& vlist, const rowcodec& codec, QString& rowdata)	// checksum by the row codec (same as GetCrc)
+{
+	EncodeRow(vlist, codec, rowdata);
+	QByteArray sha = QCryptographicHash::hash(rowdata.toUtf8(), QCryptographicHash::Sha3_512);
+	return QString::fromLocal8Bit(sha.toHex ());	// -char-
+}
+
+//-------------------------------------------------------------------------------------------------
+class CRowHasher	// checksums of the rows: several rows at once (sha3.h), the same as GetCrc
+{
+public:
+	void Add (const QVariantList& vlist, const rowcodec& codec, QStringList* pcrc) {
+		EncodeRow(vlist, codec, rowdata);
+		buf[nbuf++] = rowdata.toUtf8();
+		if (nbuf == SHA3_MAX_LANES)
+			Flush(pcrc);
+	}
+	void Flush (QStringList* pcrc) {	// after the last row
+		const unsigned char* data[SHA3_MAX_LANES];
+		size_t               len [SHA3_MAX_LANES];
+		unsigned char        dig [SHA3_MAX_LANES][SHA3_DIGEST];
+		unsigned char*       out [SHA3_MAX_LANES];
+		for (int k = 0; k < nbuf; k++) {
+			data[k] = (const unsigned char*)buf[k].constData();
+			len [k] = buf[k].size();
+			out [k] = dig[k];
+		}
+		Sha3_512_Multi(data, len, out, nbuf, lanes);
+		for (int k = 0; k < nbuf; k++)
+			pcrc->append(QString::fromLatin1(QByteArray((const char*)dig[k], SHA3_DIGEST).toHex()));
+		nbuf = 0;
+	}
+
+	int			lanes = 0;		// 0 - by CPU
+private:
+	QByteArray	buf[SHA3_MAX_LANES];
+	QString		rowdata;
+	int			nbuf  = 0;
+};
+
+//-------------------------------------------------------------------------------------------------
+inline QString CellLit (linetab* m_lines, int n, const QVariant& var)	// column data to form a query
+{
+	if (n < m_lines->m_codec.lit.size())
+		return m_lines->m_codec.lit.at(n)(var, n);
+	return SetVariantStr(m_lines->m_typeCol.at(n), var, n);
+}
+
+//-------------------------------------------------------------------------------------------------
+// keys of the rows: computed once at fetch. 1-2 integer columns are packed into k[],
+// other keys: the columns in binary form (the same value -> the same bytes)
+#define KEY_TEXT	0		// text of the column (as GetKeyStr)
+#define KEY_INT		1		// 64-bit integer
+#define KEY_BYTES	2		// blob
+
+QList<int> GetKeyKind (const QList<int>& typeCol, const QList<int>& poskey, bool bText)
+{
+	QList<int> kind;
+	for (int n = 0; n < poskey.size(); n++) {
+		int type = typeCol.at(poskey.at(n));
+		if (bText == true)	kind.append(KEY_TEXT);
+		else
+		if (type == QVariant::Int || type == QVariant::UInt || type == QVariant::LongLong || type == QVariant::ULongLong)
+							kind.append(KEY_INT);
+		else
+		if (type == QVariant::ByteArray)
+							kind.append(KEY_BYTES);
+		else				kind.append(KEY_TEXT);
+	}
+	return kind;
+}
+
+//-------------------------------------------------------------------------------------------------
+// integer value of the key column (KEY_INT). The driver gives double for some integer columns
+// (GetColTypes: float w/o precision): only a whole number is the integer, else - text of the value
+inline bool GetKeyInt (const QVariant& v, qint64& x)
+{
+	if (v.isNull() == true)
+		return false;
+	switch ((int)v.type()) {
+	case QVariant::Int:
+	case QVariant::UInt:
+	case QVariant::LongLong:
+	case QVariant::ULongLong:
+		x = v.toLongLong();
+		return true;
+	case QVariant::Double: {
+		double d = v.toDouble();
+		if (d != std::floor(d) || qAbs(d) >= 9.2e18)	// fraction, NaN, out of range
+			return false;
+		x = (qint64)d;
+		return true;
+	}
+	default: {
+		bool ok = false;
+		x = v.toLongLong(&ok);
+		return ok;
+	}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+inline void GetRowKey (const linetab* m_lines, const QList<int>& poskey, const QVariantList& vl, rowkey& key)
+{
+	key.k[0] = key.k[1] = 0;
+	key.b.resize(0);
+
+	bool bFast = (poskey.size() <= 2);
+	for (int n = 0; n < poskey.size() && bFast == true; n++) {
+		const QVariant& v = vl.at(poskey.at(n));
+		qint64 x = 0;
+		bFast = (m_lines->m_keyKind.at(n) == KEY_INT && GetKeyInt(v, x) == true);
+		if (bFast == true)
+			key.k[n] = (quint64)x;
+	}
+	if (bFast == true)
+		return;
+
+	key.k[0] = key.k[1] = 0;
+	bool bUnsupport = false;
+	for (int n = 0; n < poskey.size(); n++) {
+		int indx = poskey.at(n);
+		const QVariant& v = vl.at(indx);
+		if (v.isNull() == true) {
+			key.b.append('N');
+			continue;
+		}
+		int kind = m_lines->m_keyKind.at(n);
+		if (kind == KEY_INT) {
+			qint64 x = 0;
+			if (GetKeyInt(v, x) == true) {
+				key.b.append('I');
+				key.b.append((const char*)&x, sizeof(x));
+				continue;
+			}
+		}
+		if (kind == KEY_BYTES) {
+			QByteArray ba = v.toByteArray();
+			qint32 len = ba.size();
+			key.b.append('B');
+			key.b.append((const char*)&len, sizeof(len));
+			key.b.append(ba);
+			continue;
+		}
+		QString t = "";
+		if (indx < m_lines->m_codec.enc.size())	m_lines->m_codec.enc.at(indx)(v, t);
+		else									t = GetVariantStr(m_lines->m_typeCol.at(indx), v, bUnsupport);
+		key.b.append('T');
+		key.b.append(t.toUtf8());
+		key.b.append('\0');
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+void SetRowKeys (linetab* m_lines, const QList<int>& poskey, bool bText)	// keys of all rows
+{
+	if (m_lines->m_typeCol.size() == 0)
+		return;
+	m_lines->m_keyKind = GetKeyKind(m_lines->m_typeCol, poskey, bText);
+	m_lines->m_keyline.resize(m_lines->m_tabdata.size());
+	for (int i = 0; i < m_lines->m_tabdata.size(); i++)
+		GetRowKey (m_lines, poskey, m_lines->m_tabdata.at(i), m_lines->m_keyline[i]);
+}
+
+//-------------------------------------------------------------------------------------------------
+QList<int> GetDiffCols (linetab* m_linesS, linetab* m_linesD, int posS, int posD)	// columns with different data (same key)
+{
+	QList<int> cols;
+	const QVariantList& vS = m_linesS->m_tabdata.at(posS);
+	const QVariantList& vD = m_linesD->m_tabdata.at(posD);
+	bool bUnsupport = false;
+	for (int n = 0; n < vS.size() - 1 && n < vD.size() - 1; n++) {	// exclude rowid (last rows!)
+		bool bSame;
+		if (n < m_linesS->m_codec.cmp.size() && m_linesS->m_typeCol.at(n) == m_linesD->m_typeCol.at(n))
+			bSame = m_linesS->m_codec.cmp.at(n)(vS.at(n), vD.at(n));
+		else
+			bSame = GetVariantStr(m_linesS->m_typeCol.at(n), vS.at(n), bUnsupport) ==
+					GetVariantStr(m_linesD->m_typeCol.at(n), vD.at(n), bUnsupport);
+		if (bSame == false)
+			cols.append(n);
+	}
+	return cols;
+}
+
+//-------------------------------------------------------------------------------------------------
+QString GetDiffColsStr (tabcol* m_tabcol, const QList<int>& cols)	// for log
+{
+	QString r = "  Changed columns: ";
+	for (int n = 0; n < cols.size(); n++)
+		r += m_tabcol->col.at(cols.at(n)).trimmed() + ";";
+	return r;
+}
+
 //-------------------------------------------------------------------------------------------------
 int TriggersOn (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, bool bOn)
 {
@@ -268,12 +841,22 @@ int TriggersOn (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, bool bOn)
 	if (m_tabcol->trigg.size() < 1)	
 		return 0;
 
+	CTraceSpan tr((bOn == true) ? "triggers on" : "triggers off");
+
 	for (int i = 0; i < m_tabcol->trigg.size(); i++) {
 		QString nametrg = m_tabcol->trigg.at(i).trimmed();
 		if (nametrg.isEmpty())	
 			continue;
 
 		QString sql = "";
+		if (m_tabcol->bTrgSess == true && SqlDrv == "QPSQL") {
+			// only for the changes of DbSync, other sessions keep triggers (and FK checks!)
+			sql += "SET session_replication_role = ";
+			if (bOn == true)	sql += "DEFAULT";
+			else				sql += "replica";
+			i = m_tabcol->trigg.size();		// once for all triggers of the session
+		}
+		else
 		if (SqlDrv == "QOCI") {
 			sql += "alter trigger " + nametrg;			
 			if (bOn == true)	sql += " enable ";
@@ -327,15 +910,29 @@ int TriggersOn (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, bool bOn)
 }																				
 
 //-------------------------------------------------------------------------------------------------
-int SychroDatab(QSqlDatabase* pdb, QString SqlDrv, int mode, tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD, int posS, int posD)	// synchro row
+QString GetKeyWhere (tabcol* m_tabcol, linetab* m_lines, const QVariantList& vl)	// key columns of the row (for where)
 {
-	QSqlQuery query(*pdb);
-	QString sql = "";
-	int     err = 0;
+	QString r = "";
+	for (int n = 0; n < m_tabcol->poskey.size(); n++) {
+		int indx = m_tabcol->poskey.at(n);
+		if (m_lines->m_typeCol.at(indx) == QVariant::ByteArray)	// w/o blob parameters
+			continue;
+		r += " and " + m_tabcol->col.at(indx).trimmed();
+		if (vl.at(indx).isNull())	r += " is null";
+		else						r += "=" + CellLit(m_lines, indx, vl.at(indx));
+	}
+	return r;
+}
 
+//-------------------------------------------------------------------------------------------------
+// statement of the row change. chcol: update - changed columns only (blob parameters :idN).
+// pBlobs: blob parameters $1, $2 ... (libpq), the columns of the parameters
+int GetSyncSql(QString SqlDrv, int mode, tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD, int posS, int posD, QString& sql, QList<int>& chcol, QList<int>* pBlobs=nullptr)
+{
 	QVariantList varlS;
 	QVariantList varlD;
 	int sizelist = 0;
+	sql = "";
 
 	switch (mode)
 	{
@@ -356,7 +953,12 @@ int SychroDatab(QSqlDatabase* pdb, QString SqlDrv, int mode, tabcol* m_tabcol, l
 		sql += ") values (";
 		for (int n = 0; n < sizelist - 1; n++) {
 			if (n > 0)	sql += ",";
-			sql += SetVariantStr(m_linesS->m_typeCol.at(n), varlS.at(n), n);
+			if (pBlobs != nullptr && m_linesS->m_typeCol.at(n) == QVariant::ByteArray && varlS.at(n).isNull() == false) {
+				pBlobs->append(n);
+				sql += QString("$%1").arg(pBlobs->size());
+			}
+			else
+				sql += CellLit(m_linesS, n, varlS.at(n));
 		}
 		sql += ") ";
 		break;
@@ -364,13 +966,23 @@ int SychroDatab(QSqlDatabase* pdb, QString SqlDrv, int mode, tabcol* m_tabcol, l
 		varlS    = m_linesS->m_tabdata.at(posS);
 		sizelist = varlS.size();
 
+		chcol = GetDiffCols (m_linesS, m_linesD, posS, posD);
+		if (chcol.size() == 0)	// the difference is in the data format only - all columns
+			for (int n = 0; n < sizelist - 1; n++) chcol.append(n);
+
 		sql = "update ";
 		sql += m_tabcol->tab + " set ";
-		for (int n = 0; n < sizelist - 1; n++) {
-			if (n > 0)	sql += ",";
+		for (int c = 0; c < chcol.size(); c++) {
+			int n = chcol.at(c);
+			if (c > 0)	sql += ",";
 			sql += m_tabcol->col.at(n);
 			sql += "=";
-			sql += SetVariantStr(m_linesS->m_typeCol.at(n), varlS.at(n), n);
+			if (pBlobs != nullptr && m_linesS->m_typeCol.at(n) == QVariant::ByteArray && varlS.at(n).isNull() == false) {
+				pBlobs->append(n);
+				sql += QString("$%1").arg(pBlobs->size());
+			}
+			else
+				sql += CellLit(m_linesS, n, varlS.at(n));
 		}
 		break;
 	}
@@ -389,16 +1001,135 @@ int SychroDatab(QSqlDatabase* pdb, QString SqlDrv, int mode, tabcol* m_tabcol, l
 		else  {
 			return -21;
 		}
+		if (m_tabcol->bKeyGuard == true)	// the row can be moved (rowid)
+			sql += GetKeyWhere(m_tabcol, m_linesD, varlD);
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// plans of the generated statements (--explain): once per shape of the statement (w/o literals).
+// QPSQL: explain (estimated plan), explain (analyze, buffers) of the changes with --explain-analyze only
+// (rolled back), QOCI: explain plan. The queries are never executed again for the plan
+typedef struct _explain
+{
+	QString		sql		= "";
+	QStringList	plan;
+	double		serverMs	= -1;	// execution time on the server
+	qint64		serverRows	= -1;	// rows of the top node
+	qint64		estRows		= -1;	// estimated rows of the top node (QPSQL)
+
+} explain;
+
+typedef struct _explainlog
+{
+	QMutex			mtx;
+	QSet<QString>	shapes;			// statements with the plan
+
+} explainlog;
+
+static explainlog g_explain;
+
+//-------------------------------------------------------------------------------------------------
+bool ExplainRun (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, const QString& sql, explain& ex)	// false - w/o plan (the same shape, blob parameters)
+{
+	if (m_tabcol->bExplain == false || sql.contains(":id") == true)
+		return false;
+	QString shape = QString(sql).replace(QRegExp("'([^']|'')*'"), "?").replace(QRegExp("\\b\\d+(\\.\\d+)?\\b"), "?");
+	{
+		QMutexLocker lock(&g_explain.mtx);
+		if (g_explain.shapes.contains(shape) == true)
+			return false;
+		g_explain.shapes.insert(shape);
+	}
+
+	CTraceSpan tr("explain", sql);
+	ex.sql = sql;
+	bool bSelect = sql.trimmed().startsWith("select", Qt::CaseInsensitive);
+	QSqlQuery query(*pdb);
+	bool b = (bSelect == true || pdb->transaction() == true);
+	if (b == true) {
+		if (SqlDrv == "QPSQL") {
+			bool bAnalyze = (bSelect == false && m_tabcol->bExplainAn == true);
+			b = query.exec(((bAnalyze == true) ? "explain (analyze, buffers) " : "explain ") + sql);
+			while (b == true && query.next())
+				ex.plan.append(query.value(0).toString());
+		}
+		else
+		if (SqlDrv == "QOCI") {
+			b = query.exec("explain plan set statement_id='DbSyncPlan' for " + sql) &&
+				query.exec("select plan_table_output from table(dbms_xplan.display('PLAN_TABLE', 'DbSyncPlan', 'TYPICAL'))");
+			while (b == true && query.next())
+				ex.plan.append(query.value(0).toString());
+		}
+		else
+			b = false;
+	}
+	if (bSelect == false)
+		pdb->rollback();	// the changes of analyze, plan table
+	if (b == false) {
+		ex.plan.append("w/o plan: " + query.lastError().text().replace("\n", "; "));
+		return true;
+	}
+
+	QRegExp rxRows("actual time=[0-9.]+\\.\\.[0-9.]+ rows=(\\d+)"), rxEst("cost=[0-9.]+\\.\\.[0-9.]+ rows=(\\d+)");
+	for (int k = 0; k < ex.plan.size(); k++) {
+		const QString& line = ex.plan.at(k);
+		if (ex.serverRows < 0 && rxRows.indexIn(line) >= 0)
+			ex.serverRows = rxRows.cap(1).toLongLong();
+		if (ex.estRows < 0 && rxEst.indexIn(line) >= 0)
+			ex.estRows = rxEst.cap(1).toLongLong();
+		if (line.contains("Execution Time:") == true || line.contains("Total runtime:") == true)
+			ex.serverMs = line.section(':', 1).remove("ms").trimmed().toDouble();
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+void ExplainLog (tabcol* m_tabcol, const explain& ex, qint64 clientMs, qint64 clientRows)	// plan, server & client time
+{
+	AddLog(m_tabcol, "  Plan: " + ex.sql, false);
+	for (int k = 0; k < ex.plan.size(); k++)
+		AddLog(m_tabcol, "    " + ex.plan.at(k), false);
+	QString srv = (ex.serverMs >= 0) ? QString("%1 ms, %2 rows").arg(ex.serverMs, 0, 'f', 3).arg(ex.serverRows) :
+				  (ex.estRows  >= 0) ? QString("estimate %1 rows").arg(ex.estRows) : QString("-");
+	AddLog(m_tabcol, QString("  Server: %1; client: %2 ms, %3 rows").arg(srv).arg(clientMs).arg(clientRows), false);
+}
+
+//-------------------------------------------------------------------------------------------------
+int SychroDatab(QSqlDatabase* pdb, QString SqlDrv, int mode, tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD, int posS, int posD)	// synchro row
+{
+	QSqlQuery query(*pdb);
+	QString sql = "";
+	QList<int> chcol;	// update: changed columns only
+	int err = GetSyncSql(SqlDrv, mode, m_tabcol, m_linesS, m_linesD, posS, posD, sql, chcol);
+	if (err != 0)
+		return err;
+	int sizelist = (mode == 0) ? 0 : m_linesS->m_tabdata.at(posS).size();
+
+	if (mode == 1 && m_tabcol->bKeyGuard == true) {	// insert: the row may be added earlier
+		QString keyw = GetKeyWhere(m_tabcol, m_linesS, m_linesS->m_tabdata.at(posS));
+		QSqlQuery query0(*pdb);
+		if (keyw.isEmpty() == false &&		// blob keys only: w/o the check
+			query0.exec("select count(*) from " + m_tabcol->tab + " where 1=1" + keyw) == true && query0.next() == true && query0.value(0).toInt() > 0)
+			return -26;
 	}
-	   
+
+	explain ex;		// plan of the new shape before the change
+	bool bExplain = ExplainRun(pdb, SqlDrv, m_tabcol, sql, ex);
+	QElapsedTimer timer;
+	timer.start();
+
 	for (;;) {
 		if (pdb->transaction() == false)					{ err = -22; break; } 
 		if (query.prepare(sql) == false)					{ err = -23; break; }
 
-		// prepare blob 
-		for (int n = 0; n < sizelist - 1; n++)	{
+		// prepare blob (insert, update)
+		for (int n = 0; n < sizelist - 1 && mode != 0; n++)	{
 			if (m_linesS->m_typeCol.at(n) != QVariant::ByteArray) 
 				continue;
+			if (mode == 2 && chcol.contains(n) == false)	// the column isn't in the query
+				continue;
 			
 			QString		 xx   = QString(":id%1").arg(n);
 			QVariantList varl = m_linesS->m_tabdata.at(posS);
@@ -414,11 +1145,15 @@ int SychroDatab(QSqlDatabase* pdb, QString SqlDrv, int mode, tabcol* m_tabcol, l
 		}
 
 		if (query.exec() == false)							{ err = -24; break; }	// execute SQL (tab modify)
+		if (mode != 1 && m_tabcol->bKeyGuard == true &&
+			query.numRowsAffected() == 0)					{ pdb->rollback(); return -26; }	// the row isn't found
 		if (pdb->commit() == false)							{ err = -25; break; }
 
 		err = 0;
 		break;
 	}
+	if (bExplain == true)
+		ExplainLog (m_tabcol, ex, timer.elapsed(), (err == 0) ? query.numRowsAffected() : -1);
 
 	if (err != 0) {
 		QString x1 = query.lastError().text().replace("\n", "; ");
@@ -434,222 +1169,307 @@ int SychroDatab(QSqlDatabase* pdb, QString SqlDrv, int mode, tabcol* m_tabcol, l
 	return err;
 }
 
+#ifdef LIBPQ_ON
 //-------------------------------------------------------------------------------------------------
-inline bool Confirm (bool bAAC, const char* Msg)
+PGconn* GetPgConn (QSqlDatabase* pdb)	// connection of the Qt driver
 {
-	bool bres = true;
-	if (bAAC == false) {
-		printf ("%s", Msg);
-		int ass = getch ();
-		if (!(ass == 'Y' || ass == 'y'))   bres = false;
-		printf ("\r                                \r");
-	}
-	return bres;
-}
-
-//-------------------------------------------------------------------------------------------------
-inline QString LimitScreen (QString& txt, int limit=70)
-{
-	return (txt.size() < limit+3) ? txt : txt.mid(0, limit) + "...";
+	QVariant v = pdb->driver()->handle();
+	if (v.isValid() == false || qstrcmp(v.typeName(), "PGconn*") != 0)
+		return nullptr;
+	return *static_cast<PGconn**>(v.data());
 }
+#endif
 
 //-------------------------------------------------------------------------------------------------
-int TableComparison(QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD)
+// apply in libpq pipeline mode (QPSQL): the statements are sent w/o waiting for the results,
+// the rows between two syncs are one transaction (batch). Qt doesn't use the connection meanwhile.
+// The connection is nonblocking: while the data can't be sent, the results are read (otherwise the
+// server blocks on its output to us and we block on the input of the server)
+#define ASYNC_BATCH		500			// rows of one batch (default)
+#define ASYNC_MAX		5000		// rows of one batch (transaction)
+
+typedef struct _pipestmt
 {
-	printf ("\n------------------------------------------------------------------\n");
-	int err = 0;
-
-	// for debug
-	if (m_tabcol->bDebug == true)  AddLog(m_tabcol, "\n", false);
-
-	AddLog(m_tabcol, "Table: " + m_tabcol->tab, false);
-	QString txt = "Columns: "; for (int b=0; b < m_tabcol->col.size(); b++)	txt += m_tabcol->col.at(b) + ";"; AddLog(m_tabcol, txt, false);
-
-	// search & ignore duplicate rows
-	int DuplicateRows = 0;
-	for (int i = 0; i < m_linesS->m_crcline.size(); i++) {
-		QString crcS =  m_linesS->m_crcline.at(i);
+	int				indx	= -1;	// row of the journal
+	int				mode	= 0;	// rowact
+	QString			sql		= "";
+	QVariantList	blob;			// parameters $1..$n (bytea, binary)
 
-		for (int j = 0; j < m_linesD->m_crcline.size(); j++) {
-			QString crcD =  m_linesD->m_crcline.at(j);
+} pipestmt;
 
-			if (crcD != crcS) continue; // it isn't same row
-			// --> crcD == crcS, but rowline ?
-
-			m_linesS->m_crcline.removeAt(i);	m_linesS->m_tabdata.removeAt(i); 
-			m_linesD->m_crcline.removeAt(j);	m_linesD->m_tabdata.removeAt(j); 
-			i--; j--; DuplicateRows++;
-			break;
+class CPgPipe
+{
+public:
+	bool Begin (QSqlDatabase* pdb)
+	{
+#if defined(LIBPQ_ON) && defined(LIBPQ_HAS_PIPELINING)
+		conn = GetPgConn(pdb);
+		Reset();
+		if (conn != nullptr && PQenterPipelineMode(conn) == 1) {
+			if (PQsetnonblocking(conn, 1) == 0)
+				return true;
+			PQexitPipelineMode(conn);
 		}
+		conn = nullptr;
+#endif
+		return false;
 	}
-
-	// fix error, check flags
-	bool bChngeTrg = true;
-	if ((m_tabcol->bIgnAll == true) ||	// all ignore
-		(m_tabcol->bIgnIns == true && m_tabcol->bIgnDel == true && m_tabcol->bIgnUpd == true)) {
-		bChngeTrg = false;
+	void End ()
+	{
+#if defined(LIBPQ_ON) && defined(LIBPQ_HAS_PIPELINING)
+		if (conn != nullptr) {
+			PQsetnonblocking(conn, 0);
+			PQexitPipelineMode(conn);
+		}
+		conn = nullptr;
+#endif
 	}
-
-	if (m_tabcol->trigg.size() >  0 &&		// trigger exists
-		m_tabcol->bIgnTRG      != true  &&	// trigger isn't ignore
-		bChngeTrg			   == true)		// 2022 only if recovery db
+	bool Send (const pipestmt& st)	// queue the statement
 	{
-		if (TriggersOn (pdb, SqlDrv, m_tabcol, false) != 0)
-		{
-			QString txt1  = "Trigger isn't disabled. Data will not be changed.";
-			printf("%s\n", qPrintable(txt1));
-			AddLog(m_tabcol, txt1);
-			m_tabcol->bIgnAll = true;
+#if defined(LIBPQ_ON) && defined(LIBPQ_HAS_PIPELINING)
+		int n = st.blob.size();
+		QVector<QByteArray>  data(n);
+		QVector<const char*> vals(n);
+		QVector<int>         lens(n), fmts(n, 1);
+		for (int k = 0; k < n; k++) {
+			data[k] = st.blob.at(k).toByteArray();
+			vals[k] = (st.blob.at(k).isNull() == true) ? nullptr : data.at(k).constData();
+			lens[k] = data.at(k).size();
 		}
+		if (PQsendQueryParams(conn, st.sql.toUtf8().constData(), n, nullptr, vals.constData(), lens.constData(), fmts.constData(), 0) != 1)
+			return false;
+		batch.append(st);
+		return Flush();
+#else
+		return false;
+#endif
+	}
+	// results of the batch: 0 - committed, <0 - rolled back (errPos - the statement of the first error)
+	int Sync (int& errPos, QString& errTxt)
+	{
+		int r = 0, nb = batch.size();
+		batch.clear();
+		errPos = -1;
+#if defined(LIBPQ_ON) && defined(LIBPQ_HAS_PIPELINING)
+		CTraceSpan tr("sync", QString(), nb);
+		bool bOk = (PQpipelineSync(conn) == 1 && Flush() == true);
+		while (bOk == true && bSynced == false)		// the statements, then the sync
+			bOk = (Wait(false) == true && Read() == true);
+		if (bOk == false || nRes < nb) {		// the connection is broken
+			r = -24;
+			errTxt = QString::fromUtf8(PQerrorMessage(conn));
+		}
+		if (errFirst >= 0) {
+			r = -24;
+			errPos = errFirst;
+			errTxt = errFirstTxt;
+		}
+		Reset();
+#else
+		errTxt = "libpq pipeline mode isn't compiled";
+		r = -24;
+#endif
+		return r;
 	}
 
-	AddLog(m_tabcol, QString("-----------------------------------------"));
-	AddLog(m_tabcol, QString("- Different Rows (source DB):"));
-	bool bUnsupp = false;
-	int  indUnsC = -1;
-
-
-	// search & update different rows
-	int DifferentRows = 0;
-	for (int i = 0; i < m_linesS->m_crcline.size() && m_linesD->m_crcline.size() > 0; i++)	{
-		QString strKeyS= GetKeyStr(	m_linesS->m_typeCol, m_linesS->m_nameCol, m_linesS->m_tabdata.at(i), m_tabcol->poskey);  // source
-
-		for (int j = 0; j < m_linesD->m_crcline.size(); j++)	{
-			QString strKeyD = GetKeyStr(m_linesD->m_typeCol, m_linesD->m_nameCol, m_linesD->m_tabdata.at(j), m_tabcol->poskey);  // destination
+	QList<pipestmt>	batch;		// sent w/o results
+private:
+#ifdef LIBPQ_ON
+	PGconn*			conn = nullptr;
+#endif
+#if defined(LIBPQ_ON) && defined(LIBPQ_HAS_PIPELINING)
+	int				nRes		= 0;		// results of the batch
+	int				errFirst	= -1;		// the statement of the first error
+	QString			errFirstTxt	= "";
+	bool			bSynced		= false;	// the result of the sync
 
-			if (strKeyS != strKeyD)	// !same row, but... (2022 this is Unnecessary or Missing - key1 != key2)
+	void Reset ()
+	{
+		nRes		= 0;
+		errFirst	= -1;
+		errFirstTxt	= "";
+		bSynced		= false;
+	}
+	bool Wait (bool bWrite)		// the socket is ready (timeout: the caller tries again)
+	{
+		pollfd fd;
+		fd.fd		= PQsocket(conn);
+		fd.events	= (bWrite == true) ? (POLLIN | POLLOUT) : POLLIN;
+		fd.revents	= 0;
+		if (fd.fd < 0)
+			return false;
+#ifdef WIN32
+		WSAPoll(&fd, 1, 1000);
+#else
+		poll(&fd, 1, 1000);
+#endif
+		return true;
+	}
+	bool Read ()	// the results which are received (w/o waiting)
+	{
+		if (PQconsumeInput(conn) == 0)
+			return false;
+		int nNull = 0;		// null - the end of the statement; twice - nothing is received
+		while (PQisBusy(conn) == 0 && nNull < 2) {
+			PGresult* res = PQgetResult(conn);
+			if (res == nullptr) {
+				nNull++;
 				continue;
-		
-			// this is diff row (key1==key2)
-			QVariantList vlist = m_linesS->m_tabdata.at(i);
-			QString ScreenStr  = GetRows (&vlist, &m_linesS->m_typeCol, bUnsupp, indUnsC).replace("\n"," | ").replace("\r"," ");
-			AddLog(m_tabcol, ScreenStr);
-
-			// for debug
-			if (m_tabcol->bDebug == true) {
-				bool bx0 = false; int bx1 = 0;
-				QVariantList vlisS = m_linesS->m_tabdata.at(i);
-				QString   DebugSrc = "  *S:  " + GetRows (&vlisS, &m_linesS->m_typeCol, bx0, bx1);
-
-				QVariantList vlisD = m_linesD->m_tabdata.at(j);
-				QString   DebugDst = "  *D:  " + GetRows (&vlisD, &m_linesD->m_typeCol, bx0, bx1);
-
-				AddLog(m_tabcol, DebugSrc, false);
-				AddLog(m_tabcol, DebugDst, false);
-			}
-
-			if (bUnsupp == true) {
-				QString terr = QString ("Column type unsupported (%1)\n").arg(indUnsC);
-				printf ("%s", qPrintable(terr));
-				AddLog(m_tabcol, terr);
-			}
-
-			int nChangeRow = 1;
-			if (m_tabcol->bIgnAll == false && 
-				m_tabcol->bIgnUpd == false) 
-			{
-				printf ("Different  : %s\n", qPrintable(LimitScreen(ScreenStr)));
-				bool bY = Confirm (m_tabcol->bAAC, "Replace data (y/n) ?");
-				if (bY == true) {
-					int err0 = SychroDatab(pdb, SqlDrv, 2, m_tabcol, m_linesS, m_linesD, i, j); // update
-					if (err0 == 0) { DuplicateRows++;  nChangeRow = 0; } else err  += err0;
-				}
 			}
+			nNull = 0;
+			ExecStatusType st = PQresultStatus(res);
+			if (st == PGRES_PIPELINE_SYNC)
+				bSynced = true;
 			else {
-				printf ("Different  : %s\n", qPrintable(LimitScreen(strKeyS)));
+				if (st != PGRES_COMMAND_OK && st != PGRES_PIPELINE_ABORTED && errFirst < 0) {
+					errFirst = nRes;
+					errFirstTxt = QString::fromUtf8(PQresultErrorMessage(res));
+				}
+				nRes++;
 			}
-
-			m_linesS->m_crcline.removeAt(i);	m_linesS->m_tabdata.removeAt(i);
-			m_linesD->m_crcline.removeAt(j);	m_linesD->m_tabdata.removeAt(j);
-			i--; j--; DifferentRows += nChangeRow;
-			break;
+			PQclear(res);
 		}
+		return true;
 	}
-
-	AddLog(m_tabcol, QString("-----------------------------------------"));
-	AddLog(m_tabcol, QString("- Unnecessary Rows (destination DB):"));
-	bUnsupp = false;
-	indUnsC = -1;
-
-	// delete unwanted rows
-	int UnnecessRows = 0;
-	for (int j = 0; j < m_linesD->m_crcline.size(); j++)	{
-
-		QVariantList vlist = m_linesD->m_tabdata.at(j);
-		QString ScreenStr = GetRows (&vlist, &m_linesD->m_typeCol, bUnsupp, indUnsC).replace("\n"," | ").replace("\r"," ");
-		AddLog(m_tabcol, ScreenStr);
-		if (bUnsupp == true) {
-			QString terr = QString ("Column type unsupported (%1)\n").arg(indUnsC);
-			printf ("%s", qPrintable(terr));
-			AddLog(m_tabcol, terr);
+	bool Flush ()	// send the queued data, the results are read meanwhile
+	{
+		for (;;) {
+			int f = PQflush(conn);
+			if (f == 0)	return true;
+			if (f <  0)	return false;
+			if (Wait(true) == false || Read() == false)
+				return false;
 		}
+	}
+#endif
+};
 
-		int nChangeRow = 1;
-		if (m_tabcol->bIgnAll == false && 
-			m_tabcol->bIgnDel == false) {
-			printf ("Unnecessary: %s\n", qPrintable(LimitScreen(ScreenStr)));
-			bool bY = Confirm (m_tabcol->bAAC, "Delete data (y/n) ?");
-			if (bY == true) {
-				int err0 = SychroDatab(pdb, SqlDrv, 0, m_tabcol, m_linesS, m_linesD, 0, j);	// delete;				
-				if (err0 == 0) { DuplicateRows++;  nChangeRow = 0; } else err  += err0;
-			}
-		}
-		else {
-			QString strKeyD = GetKeyStr(m_linesD->m_typeCol, m_linesD->m_nameCol, m_linesD->m_tabdata.at(j), m_tabcol->poskey);  // destination
-			printf ("Unnecessary: %s\n", qPrintable(LimitScreen(strKeyD)));
-		}
+//-------------------------------------------------------------------------------------------------
+inline bool IsAsyncApply (tabcol* m_tabcol, QString SqlDrv)
+{
+	return m_tabcol->asyncBatch > 0 && SqlDrv == "QPSQL";
+}
 
-		UnnecessRows += nChangeRow;	// 2022 - 
+//-------------------------------------------------------------------------------------------------
+int AsyncSend (CPgPipe* pp, QString SqlDrv, int mode, tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD, int indx)	// statement of the row into the pipeline
+{
+	pipestmt st;
+	QList<int> chcol, blobs;	// blob parameters $k
+	int err = GetSyncSql(SqlDrv, mode, m_tabcol, m_linesS, m_linesD, 0, 0, st.sql, chcol, &blobs);
+	if (err != 0)
+		return err;
+	st.indx = indx;
+	st.mode = mode;
+
+	for (int k = 0; k < blobs.size(); k++)
+		st.blob.append(m_linesS->m_tabdata.at(0).at(blobs.at(k)));
+
+	if (pp->Send(st) == false) {
+		printf("SQL execution error: the statement isn't sent (pipeline)\n");
+		AddLog(m_tabcol, "SQL: " + st.sql, false);
+		return -24;
 	}
+	return 0;
+}
 
-	AddLog(m_tabcol, QString("-----------------------------------------"));
-	AddLog(m_tabcol, QString("- Missing Rows (source DB):"));
-	bUnsupp = false;
-	indUnsC = -1;
-
-	// add missing rows
-	int MissingRows = 0;
-	for (int i = 0; i < m_linesS->m_crcline.size(); i++)	{
+//-------------------------------------------------------------------------------------------------
+// results of the sent rows: done - the rows are committed (pipestmt).
+// if the batch is rolled back, its rows are sent again one by one: the errors are matched to the rows
+int AsyncFlush (CPgPipe* pp, tabcol* m_tabcol, QList<pipestmt>& done)
+{
+	if (pp->batch.size() == 0)
+		return 0;
 
-		QVariantList vlist = m_linesS->m_tabdata.at(i);
-		QString ScreenStr  = GetRows (&vlist, &m_linesS->m_typeCol, bUnsupp, indUnsC).replace("\n"," | ").replace("\r"," ");
-		AddLog(m_tabcol, ScreenStr);
-		if (bUnsupp == true) {
-			QString terr = QString ("Column type unsupported (%1)\n").arg(indUnsC);
-			printf ("%s", qPrintable(terr));
-			AddLog(m_tabcol, terr);
-		}
+	QList<pipestmt> sent = pp->batch;
+	int errPos = -1;
+	QString errTxt;
+	if (pp->Sync(errPos, errTxt) == 0) {
+		done.append(sent);
+		return 0;
+	}
 
-		int nChangeRow = 1;
-		if (m_tabcol->bIgnAll == false && 
-			m_tabcol->bIgnIns == false) {
-			printf ("Missing    : %s\n", qPrintable(LimitScreen(ScreenStr)));
-			bool bY = Confirm (m_tabcol->bAAC, "Insert data (y/n) ?");
-			if (bY == true) {
-				int err0 = SychroDatab(pdb, SqlDrv, 1, m_tabcol, m_linesS, m_linesD, i, 0);	// insert
-				if (err0 == 0) { DuplicateRows++;  nChangeRow = 0; } else err  += err0;
+	int err = 0;
+	bool bSingle = sent.size() > 1 && errPos >= 0;	// the rows of the batch are the same, the error of a row
+	for (int k = 0; k < sent.size(); k++) {
+		if (bSingle == true) {
+			if (pp->Send(sent.at(k)) == true && pp->Sync(errPos, errTxt) == 0) {
+				done.append(sent.at(k));
+				continue;
 			}
 		}
-		else {
-			QString strKeyS	= GetKeyStr(m_linesS->m_typeCol, m_linesS->m_nameCol, m_linesS->m_tabdata.at(i), m_tabcol->poskey);  // source
-			printf ("Missing    : %s\n", qPrintable(LimitScreen(strKeyS)));
+		else
+		if (k != errPos && errPos >= 0) {
+			continue;
 		}
+		QString x1 = errTxt.trimmed().replace("\n", "; ");
+		printf("SQL execution error: %s\n", qPrintable(x1));
+		AddLog(m_tabcol, "Err: " + x1, false);
+		AddLog(m_tabcol, "SQL: " + sent.at(k).sql, false);
+		AddLog(m_tabcol, "     ");
+		err += -24;
+		if (bSingle == false && errPos < 0)	// the connection is broken: one message
+			break;
+	}
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline bool Confirm (bool bAAC, const char* Msg)
+{
+	bool bres = true;
+	if (bAAC == false) {
+		printf ("%s", Msg);
+		int ass = getch ();
+		if (!(ass == 'Y' || ass == 'y'))   bres = false;
+		printf ("\r                                \r");
+	}
+	return bres;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline QString LimitScreen (QString& txt, int limit=70)
+{
+	return (txt.size() < limit+3) ? txt : txt.mid(0, limit) + "...";
+}
 
-		MissingRows += nChangeRow;
+//-------------------------------------------------------------------------------------------------
+inline bool IsRecovery (tabcol* m_tabcol)	// data will be changed
+{
+	if ((m_tabcol->bIgnAll == true) ||	// all ignore
+		(m_tabcol->bIgnIns == true && m_tabcol->bIgnDel == true && m_tabcol->bIgnUpd == true)) {
+		return false;
 	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline bool IsThrottle (tabcol* m_tabcol)
+{
+	return m_tabcol->thr.maxRate > 0 || m_tabcol->thr.maxLat > 0 || m_tabcol->thr.maxLag > 0;
+}
 
-	if (bChngeTrg == true && // 2022 only if recovery db
-		m_tabcol->bIgnTRG == false &&
-		m_tabcol->trigg.size() > 0) 
+//-------------------------------------------------------------------------------------------------
+void SyncTriggers (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, bool bChngeTrg, bool bOn)	// triggers off/on during synchronization
+{
+	if (m_tabcol->trigg.size() >  0 &&		// trigger exists
+		m_tabcol->bIgnTRG      != true  &&	// trigger isn't ignore
+		bChngeTrg			   == true)		// 2022 only if recovery db
 	{
-		if (TriggersOn (pdb, SqlDrv, m_tabcol, true) != 0)
+		if (TriggersOn (pdb, SqlDrv, m_tabcol, bOn) != 0)
 		{
-			QString txt1  = "Trigger isn't enabled. Check database!";
-			printf ("%s\n", qPrintable(txt1));
+			QString txt1  = (bOn == true) ? "Trigger isn't enabled. Check database!" : "Trigger isn't disabled. Data will not be changed.";
+			printf("%s\n", qPrintable(txt1));
 			AddLog(m_tabcol, txt1);
 			m_tabcol->bIgnAll = true;
 		}
 	}
+}
+
+//-------------------------------------------------------------------------------------------------
+void PrintTotals (tabcol* m_tabcol, bool bChngeTrg, int DuplicateRows, int DifferentRows, int UnnecessRows, int MissingRows, int err)
+{
+	m_tabcol->total[0] = DuplicateRows;	m_tabcol->total[1] = DifferentRows;
+	m_tabcol->total[2] = UnnecessRows;	m_tabcol->total[3] = MissingRows;
 
 	AddLog(m_tabcol, QString("-----------------------------------------"));
 	printf ("\n------------------------------------------------------------------\n");	// 2022 - always print
@@ -668,290 +1488,3587 @@ int TableComparison(QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, linetab
 	AddLog(m_tabcol, QString("   Unnecessary rows (Only Dst): %1").arg(UnnecessRows ));	qInfo () << "- Unnecessary rows (Only Dst): " << UnnecessRows;
 	AddLog(m_tabcol, QString("   Missing     rows (Only Src): %1").arg(MissingRows  ));	qInfo () << "- Missing     rows (Only Src): " << MissingRows ;
 
+	if (IsThrottle(m_tabcol) == true || m_tabcol->thr.waitMs > 0) {
+		QString tt = QString("   Apply pauses (throttling) : %1 sec").arg(m_tabcol->thr.waitMs / 1000., 0, 'f', 1);
+		AddLog(m_tabcol, tt);	printf ("%s\n", qPrintable(tt));
+	}
+
 	if (err != 0) {
 		QString tt = "Warning: there were errors when changing the data in the table.";
 		printf ("\n%s\n",qPrintable(tt));	// 2022 fix )
 		AddLog(m_tabcol, tt);
 	}
-	return err;
 }
 
 //-------------------------------------------------------------------------------------------------
-int SaveErr (QSqlQuery* p, QString sql, tabcol*	m_tabcol, int err)
+inline linetab GetHead (linetab* m_lines)	// columns type & codec (w/o rows)
 {
-	QString x1 = p->lastError().text().replace("\n", "; ");
-	printf ("SQL execution error: %s\n", qPrintable(x1));
-	AddLog(m_tabcol, "Err: " + x1 ,false);
-	AddLog(m_tabcol, "SQL: " + sql,false);
-	AddLog(m_tabcol, " ");
-	return err;
+	linetab head;
+	head.m_typeCol = m_lines->m_typeCol;
+	head.m_nameCol = m_lines->m_nameCol;
+	head.m_codec   = m_lines->m_codec;
+	return head;
 }
 
-//-------------------------------------------------------------------------------
-//
-class CMyDbThread : public QThread
+//-------------------------------------------------------------------------------------------------
+void ThrottleWait (QSqlDatabase* pdb, tabcol* m_tabcol)	// pause before the change (rate, latency, lag)
 {
-public:
-	CMyDbThread (QObject *parent = NULL) : QThread(parent) { //-V730
-		pDb = nullptr;
+	throttle& t = m_tabcol->thr;
+	if (IsThrottle(m_tabcol) == false)
+		return;
+	CTraceSpan tr("throttle");
+	if (t.timer.isValid() == false)
+		t.timer.start();
+
+	qint64 pause = (qint64)t.delay;
+	if (t.maxRate > 0) {
+		qint64 due = (qint64)(t.rows * 1000. / t.maxRate);	// time of the row by the rate
+		pause = qMax(pause, due - t.timer.elapsed());
 	}
-	void run() override
-	{
-#ifdef CRASH_ON
-		crInstallToCurrentThread2(0);
-#endif
-		QSqlQuery query(*pDb);
-		bool b = query.exec(tsql);
-		if (b == false) {
-			// return SaveErr (&query, cnttest, m_tabcol, -31);
-			CodeErr = 1;
-			DbErr	= query.lastError().text().replace("\n", "; ");
-#ifdef CRASH_ON
-			crUninstallFromCurrentThread();
-#endif
-			return;
+	if (pause > 0) {
+		QThread::msleep(pause);
+		t.waitMs += pause;
+	}
+
+	// replication lag: wait while the standby is behind
+	while (t.maxLag > 0 && t.timer.elapsed() >= t.nextLag) {
+		QSqlQuery query(*pdb);
+		if (query.exec(t.lagSql) == false || query.next() == false) {
+			QString tt = "Warning ! Lag query error, the lag isn't controlled: " + query.lastError().text().replace("\n", "; ");
+			printf ("%s\n", qPrintable(tt));
+			AddLog(m_tabcol, tt, false);
+			t.maxLag = 0;
+			break;
+		}
+		double lag = query.value(0).toDouble();
+		if (lag <= t.maxLag) {
+			t.nextLag = t.timer.elapsed() + 1000;	// once per second
+			break;
 		}
+		printf ("Apply paused: replication lag %.1f sec\r", lag);
+		QThread::msleep(1000);
+		t.waitMs += 1000;
+	}
+}
 
-		QSqlRecord rec = query.record();
-		int  cntField  = rec.count();
-		for (int n = 0; n < cntField; n++)	{
-			QSqlField  oField	= rec.field(n);
-			QString    nname	= oField.name();
-			QVariant   vartype	= oField.type();
-			int			precis	= oField.precision();
-			int			typeCol =(int)vartype.type();
-			if (typeCol == (int)QVariant::Double && precis <= 0)
-					typeCol = QVariant::Int;
+//-------------------------------------------------------------------------------------------------
+void ThrottleDone (tabcol* m_tabcol, qint64 latency)	// the statement is executed (msec)
+{
+	throttle& t = m_tabcol->thr;
+	t.rows++;
+	if (t.maxLat <= 0)
+		return;
+	if (latency > t.maxLat)	t.delay = qMin(qMax(t.delay * 2, 10.), 5000.);	// the destination is busy - slower
+	else					t.delay = (t.delay < 1) ? 0 : t.delay * 0.9;	// faster
+}
 
-			m_lines.m_nameCol.append(nname);
-			m_lines.m_typeCol.append(typeCol);
-		}
+//-------------------------------------------------------------------------------------------------
+// log, confirm and change of one row. bDone - the row is changed in the destination Db
+// setState: 0 - change the row, 1 - the row is changed by the set (log only), 2 - the set is declined
+// pPipe: the row is sent into the pipeline (the result - after the sync), indx - row of the journal
+int ApplyRowAct (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, linetab* headS, linetab* headD, const rowact& act, bool bLabel, bool& bDone,
+				 int setState = 0, CPgPipe* pPipe = nullptr, int indx = -1)
+{
+	bDone = false;
+	linetab rowS = *headS, rowD = *headD;
+	if (act.mode != 0)	rowS.m_tabdata.append(act.rowS);
+	if (act.mode != 1)	rowD.m_tabdata.append(act.rowD);
 
-		m_lines.m_tabdata.reserve(maxRow);
-		m_lines.m_crcline.reserve(maxRow);
-		
-		bool bUnsupport = false;
-		int  indxUnsupp = -1;
+	bool         bUnsupp = false;
+	int          indUnsC = -1;
+	linetab*     pshow   = (act.mode == 0) ? &rowD : &rowS;
+	QVariantList vlist   = pshow->m_tabdata.at(0);
+	QString ScreenStr    = GetRows (&vlist, &pshow->m_typeCol, bUnsupp, indUnsC).replace("\n"," | ").replace("\r"," ");
 
-		// read records
-		while (query.next())	{
-			QVariantList mvlist;
-			for (int n = 0; n < cntField; n++)
-				mvlist.append(query.value(n));
-		
-			QString rd = "";
-			m_lines.m_tabdata.append( mvlist );
-			m_lines.m_crcline.append( GetCrc(&mvlist, &m_lines.m_typeCol, bUnsupport, indxUnsupp) );
-		} 
+	const char* label = (act.mode == 2) ? "Different  : " : (act.mode == 0) ? "Unnecessary: " : "Missing    : ";
+	const char* quest = (act.mode == 2) ? "Replace data (y/n) ?" : (act.mode == 0) ? "Delete data (y/n) ?" : "Insert data (y/n) ?";
+	bool        bIgn  = (act.mode == 2) ? m_tabcol->bIgnUpd : (act.mode == 0) ? m_tabcol->bIgnDel : m_tabcol->bIgnIns;
 
-		m_lines.b_Unsuppt	= bUnsupport;
-		m_lines.ColUnsupp	= indxUnsupp;
-		CodeErr				= 0;
-#ifdef CRASH_ON
-		crUninstallFromCurrentThread();
-#endif
+	AddLog(m_tabcol, (bLabel == true) ? label + ScreenStr : ScreenStr);
+	if (act.mode == 2)
+		AddLog(m_tabcol, GetDiffColsStr(m_tabcol, GetDiffCols(&rowS, &rowD, 0, 0)));
+
+	// for debug
+	if (m_tabcol->bDebug == true && act.mode == 2) {
+		bool bx0 = false; int bx1 = 0;
+		QVariantList vlisS = act.rowS, vlisD = act.rowD;
+		AddLog(m_tabcol, "  *S:  " + GetRows (&vlisS, &rowS.m_typeCol, bx0, bx1), false);
+		AddLog(m_tabcol, "  *D:  " + GetRows (&vlisD, &rowD.m_typeCol, bx0, bx1), false);
 	}
 
-	QString		 tsql = "";
-	QSqlDatabase* pDb = nullptr;
-	int		Instance  = -1;
-	QString DbErr	  = "";
-	int		CodeErr	  = -101;
-	int		maxRow	  = 1;
-	linetab	m_lines;
-};
+	if (bUnsupp == true) {
+		QString terr = QString ("Column type unsupported (%1)\n").arg(indUnsC);
+		printf ("%s", qPrintable(terr));
+		AddLog(m_tabcol, terr);
+	}
 
+	int err = 0;
+	if (m_tabcol->bIgnAll == false && bIgn == false) {
+		printf ("%s%s\n", label, qPrintable(LimitScreen(ScreenStr)));
+		if (setState == 1)
+			bDone = true;
+		bool bY = (setState == 0) ? Confirm (m_tabcol->bAAC, quest) : false;
+		if (bY == true && pPipe != nullptr) {
+			err = AsyncSend (pPipe, SqlDrv, act.mode, m_tabcol, &rowS, &rowD, indx);
+		}
+		else
+		if (bY == true) {
+			ThrottleWait (pdb, m_tabcol);
+			QElapsedTimer tm; tm.start();
+			CTraceSpan tr((act.mode == 2) ? "update" : (act.mode == 0) ? "delete" : "insert", QString(), 1);
+			err = SychroDatab(pdb, SqlDrv, act.mode, m_tabcol, &rowS, &rowD, 0, 0);
+			ThrottleDone (m_tabcol, tm.elapsed());
+			if (err == 0)
+				bDone = true;
+		}
+	}
+	else {
+		QString strKey = GetKeyStr(pshow->m_typeCol, pshow->m_nameCol, vlist, m_tabcol->poskey);
+		printf ("%s%s\n", label, qPrintable(LimitScreen(strKey)));
+	}
+	return err;
+}
 
 //-------------------------------------------------------------------------------------------------
-// reading data in multiple threads.
-int GetDataTable(QList<QSqlDatabase*> m_db, QString SqlDrv, tabcol*	m_tabcol, linetab* m_lines)
-{
-	int    maxConnect = m_db.size();
-	QSqlDatabase* pdb = m_db.at(0);				// for simple queries
-	QString nameRID	  = "DbSyncExtentKeyId";	// Aliases for special database fields. 
-	QString nameRNM	  = "DbSyncExtentRowNum";	// Must be unique, do not match table fields
+// journal of the changes: header, rows to change, then the numbers of the processed rows
+#define JRN_APPLIED		1		// the change is committed
+#define JRN_STALE		2		// the row of the destination was changed after the journal
 
-	// get rows count
-	QString cnttest = "select count(*) from " + m_tabcol->tab;
-	m_tabcol->where = m_tabcol->where.trimmed();
-	if (m_tabcol->where.isEmpty() == false) {
-		cnttest += " where ";
-		cnttest += m_tabcol->where;
-	}	
+int JournalCreate (journal* jr)
+{
+	jr->pf = new QFile(jr->path);
+	if (jr->pf->open(QIODevice::WriteOnly | QIODevice::Truncate) == false) {
+		printf ("Warning ! Journal isn't created: %s\n", qPrintable(jr->path));
+		delete jr->pf; jr->pf = nullptr;
+		return -50;
+	}
+	QDataStream ds(jr->pf);
+	ds.setVersion(QDataStream::Qt_5_11);
+	ds << QString("DbSyncJournal") << (qint32)1 << jr->ident << jr->typeS << jr->typeD << (qint32)jr->Identical << (qint32)jr->acts.size();
+	for (int k = 0; k < jr->acts.size(); k++)
+		ds << (qint32)jr->acts.at(k).mode << jr->acts.at(k).rowS << jr->acts.at(k).rowD;
+	jr->pf->flush();
+	return 0;
+}
 
-	// for debug
-	if (m_tabcol->bDebug == true) AddLog(m_tabcol, "  " + cnttest, false);
+//-------------------------------------------------------------------------------------------------
+int JournalLoad (journal* jr)
+{
+	QFile ff(jr->path);
+	if (ff.open(QIODevice::ReadOnly) == false)
+		return -50;
+
+	QDataStream ds(&ff);
+	ds.setVersion(QDataStream::Qt_5_11);
+	QString magic; qint32 vers = 0, ident = 0, cnt = 0;
+	QByteArray hh;
+	ds >> magic >> vers >> hh >> jr->typeS >> jr->typeD >> ident >> cnt;
+	if (ds.status() != QDataStream::Ok || magic != "DbSyncJournal" || vers != 1 || hh != jr->ident)
+		return -51;
+
+	jr->Identical = ident;
+	for (int k = 0; k < cnt; k++) {
+		rowact act; qint32 mode = 0;
+		ds >> mode >> act.rowS >> act.rowD;
+		act.mode = mode;
+		jr->acts.append(act);
+	}
+	if (ds.status() != QDataStream::Ok)
+		return -51;
+
+	jr->state.fill(0, jr->acts.size());
+	for (;;) {		// processed rows (the last record may be broken)
+		qint32 indx = -1; qint8 st = 0;
+		ds >> indx >> st;
+		if (ds.status() != QDataStream::Ok)
+			break;
+		if (indx >= 0 && indx < jr->state.size())
+			jr->state[indx] = st;
+	}
+
+	jr->pf = new QFile(jr->path);
+	if (jr->pf->open(QIODevice::WriteOnly | QIODevice::Append) == false) {
+		delete jr->pf; jr->pf = nullptr;
+		return -50;
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+void JournalMark (journal* jr, int indx, int state)
+{
+	if (jr == nullptr || jr->pf == nullptr)
+		return;
+	QDataStream ds(jr->pf);
+	ds.setVersion(QDataStream::Qt_5_11);
+	ds << (qint32)indx << (qint8)state;
+	jr->pf->flush();
+}
+
+//-------------------------------------------------------------------------------------------------
+void JournalClose (journal* jr, bool bRemove)
+{
+	if (jr->pf == nullptr)
+		return;
+	jr->pf->close();
+	delete jr->pf; jr->pf = nullptr;
+	if (bRemove == true)	QFile::remove(jr->path);
+	else					printf ("Journal of the changes: %s (continue: --resume)\n", qPrintable(jr->path));
+}
+
+//-------------------------------------------------------------------------------------------------
+// set-based apply (QPSQL): the rows are loaded into a staging table (COPY or multi-row insert),
+// then one delete and one merge (update + insert before PostgreSQL 15) in one transaction
+#define SET_BATCH		500			// rows of one insert into the staging table (w/o libpq)
+
+inline bool IsSetApply (tabcol* m_tabcol, QString SqlDrv)
+{
+	return m_tabcol->bSetApply == true && SqlDrv == "QPSQL" && m_tabcol->poskey.size() > 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline QString StageLit (linetab* m_lines, int n, const QVariant& var)	// column data for the insert (w/o blob parameters)
+{
+	if (m_lines->m_typeCol.at(n) == QVariant::ByteArray && var.isNull() == false)
+		return "decode('" + QString::fromLatin1(var.toByteArray().toHex()) + "','hex')";
+	return CellLit(m_lines, n, var);
+}
+
+#ifdef LIBPQ_ON
+//-------------------------------------------------------------------------------------------------
+QByteArray CopyCell (int type, const QVariant& var)	// column data for COPY (text format)
+{
+	if (var.isNull())
+		return "\\N";
+
+	QString t;
+	switch (type) {
+	case QVariant::DateTime:	t = var.toDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");	break;
+	case QVariant::Date:		t = var.toDate().toString("yyyy-MM-dd");					break;
+	case QVariant::Time:		t = var.toTime().toString("hh:mm:ss.zzz");					break;
+	case QVariant::ByteArray:	return "\\\\x" + var.toByteArray().toHex();
+	default:					t = var.toString();											break;
+	}
+
+	QByteArray u = t.toUtf8(), r;
+	r.reserve(u.size());
+	for (int k = 0; k < u.size(); k++) {
+		char c = u.at(k);
+		if      (c == '\\')	r += "\\\\";
+		else if (c == '\t')	r += "\\t";
+		else if (c == '\n')	r += "\\n";
+		else if (c == '\r')	r += "\\r";
+		else				r += c;
+	}
+	return r;
+}
+
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// rows of the set into the staging table: source rows (U - update, I - insert), destination rows (D - delete)
+int StageLoad (QSqlDatabase* pdb, tabcol* m_tabcol, linetab* headS, linetab* headD, const QList<const rowact*>& acts, QString& errTxt)
+{
+	CTraceSpan tr("stage load", m_tabcol->tab, acts.size());
+	int ncol = m_tabcol->col.size();
+	QString cols = "";
+	for (int n = 0; n < ncol; n++)
+		cols += m_tabcol->col.at(n).trimmed() + ",";
+	cols += "DbSyncOp";
+
+#ifdef LIBPQ_ON
+	PGconn* conn = GetPgConn(pdb);
+	if (conn != nullptr) {
+		PGresult* res = PQexec(conn, ("copy DbSyncStage (" + cols + ") from stdin").toUtf8().constData());
+		bool bOk = (PQresultStatus(res) == PGRES_COPY_IN);
+		PQclear(res);
+		if (bOk == false) {
+			errTxt = QString::fromUtf8(PQerrorMessage(conn));
+			return -28;
+		}
+
+		QByteArray buf;
+		for (int k = 0; k < acts.size() && bOk == true; k++) {
+			const rowact* pa = acts.at(k);
+			linetab*      ph = (pa->mode == 0) ? headD : headS;
+			const QVariantList& vl = (pa->mode == 0) ? pa->rowD : pa->rowS;
+			for (int n = 0; n < ncol; n++) {
+				buf += CopyCell(ph->m_typeCol.at(n), vl.at(n));
+				buf += '\t';
+			}
+			buf += (pa->mode == 2) ? "U\n" : (pa->mode == 0) ? "D\n" : "I\n";
+			if (buf.size() >= (1 << 20) || k == acts.size() - 1) {
+				bOk = (PQputCopyData(conn, buf.constData(), buf.size()) == 1);
+				buf.clear();
+			}
+		}
+		PQputCopyEnd(conn, (bOk == true) ? nullptr : "DbSync: rows aren't sent");
+		while ((res = PQgetResult(conn)) != nullptr) {
+			if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+				errTxt = QString::fromUtf8(PQresultErrorMessage(res));
+				bOk    = false;
+			}
+			PQclear(res);
+		}
+		return (bOk == true) ? 0 : -28;
+	}
+#endif
+
+	QSqlQuery query(*pdb);
+	for (int k0 = 0; k0 < acts.size(); k0 += SET_BATCH) {
+		QString sql = "insert into DbSyncStage (" + cols + ") values ";
+		for (int k = k0; k < acts.size() && k < k0 + SET_BATCH; k++) {
+			const rowact* pa = acts.at(k);
+			linetab*      ph = (pa->mode == 0) ? headD : headS;
+			const QVariantList& vl = (pa->mode == 0) ? pa->rowD : pa->rowS;
+			sql += (k == k0) ? "(" : ",(";
+			for (int n = 0; n < ncol; n++)
+				sql += StageLit(ph, n, vl.at(n)) + ",";
+			sql += (pa->mode == 2) ? "'U')" : (pa->mode == 0) ? "'D')" : "'I')";
+		}
+		if (query.exec(sql) == false) {
+			errTxt = query.lastError().text();
+			return -28;
+		}
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// all changes of the table as one set. 0 - applied, 1 - declined, <0 - error (rollback, the rows are applied one by one)
+int ApplySet (QSqlDatabase* pdb, tabcol* m_tabcol, linetab* headS, linetab* headD, journal* jr)
+{
+	QList<const rowact*> acts;
+	int nAct[3] = { 0, 0, 0 };	// unnecessary, missing, different
+	for (int k = 0; k < jr->acts.size(); k++) {
+		const rowact& act = jr->acts.at(k);
+		bool bIgn = (act.mode == 2) ? m_tabcol->bIgnUpd : (act.mode == 0) ? m_tabcol->bIgnDel : m_tabcol->bIgnIns;
+		if (bIgn == true || (k < jr->state.size() && jr->state.at(k) == JRN_APPLIED))
+			continue;
+		acts.append(&act);
+		nAct[act.mode]++;
+	}
+	if (acts.size() == 0)
+		return -1;
+
+	QString tt = QString("Set apply: %1 different, %2 unnecessary, %3 missing rows").arg(nAct[2]).arg(nAct[0]).arg(nAct[1]);
+	printf ("%s\n", qPrintable(tt));
+	AddLog(m_tabcol, tt);
+	QString quest = QString("Apply %1 changes as one set (y/n) ?").arg(acts.size());
+	if (Confirm (m_tabcol->bAAC, qPrintable(quest)) == false)
+		return 1;
+
+	CTraceSpan tr("apply set", m_tabcol->tab, acts.size());
+	QString cols = "", vals = "", keys = "", sets = "";
+	for (int n = 0; n < m_tabcol->col.size(); n++) {
+		QString c = m_tabcol->col.at(n).trimmed();
+		cols += ((n > 0) ? "," : "") + c;
+		vals += ((n > 0) ? ",s." : "s.") + c;
+		if (m_tabcol->poskey.contains(n) == true)	keys += " and t." + c + "=s." + c;
+		else										sets += ((sets.isEmpty() == true) ? "" : ",") + c + "=s." + c;
+	}
+
+	QSqlQuery query(*pdb);
+	int vers = 0;
+	if (query.exec("show server_version_num") == true && query.next() == true)
+		vers = query.value(0).toInt();
+
+	int err = 0, nUpd = (sets.isEmpty() == true) ? 0 : nAct[2];
+	QString sql = "", errTxt = "";
+	for (;;) {
+		if (pdb->transaction() == false)	{ err = -22; break; }
+		sql = "create temp table DbSyncStage on commit drop as select " + cols + ", cast(null as char(1)) DbSyncOp from " + m_tabcol->tab + " where 1=0";
+		if (query.exec(sql) == false)		{ err = -24; break; }
+		sql = "copy DbSyncStage";
+		if (StageLoad (pdb, m_tabcol, headS, headD, acts, errTxt) != 0)	{ err = -28; break; }
+
+		if (nAct[0] > 0) {
+			CTraceSpan tr1("delete", QString(), nAct[0]);
+			sql = "delete from " + m_tabcol->tab + " t using DbSyncStage s where s.DbSyncOp='D'" + keys;
+			if (query.exec(sql) == false)						{ err = -24; break; }
+			if (query.numRowsAffected() != nAct[0])				{ err = -27; break; }
+		}
+
+		if (vers >= 150000 && nUpd + nAct[1] > 0) {
+			CTraceSpan tr1("merge", QString(), nUpd + nAct[1]);
+			sql = "merge into " + m_tabcol->tab + " t using (select * from DbSyncStage where DbSyncOp<>'D') s on (" + keys.mid(5) + ")";
+			if (nUpd > 0)	sql += " when matched then update set " + sets;
+			sql += " when not matched then insert (" + cols + ") values (" + vals + ")";
+			if (query.exec(sql) == false)						{ err = -24; break; }
+			if (query.numRowsAffected() != nUpd + nAct[1])		{ err = -27; break; }
+		}
+		else {
+			if (nUpd > 0) {
+				CTraceSpan tr1("update", QString(), nUpd);
+				sql = "update " + m_tabcol->tab + " t set " + sets + " from DbSyncStage s where s.DbSyncOp='U'" + keys;
+				if (query.exec(sql) == false)					{ err = -24; break; }
+				if (query.numRowsAffected() != nUpd)			{ err = -27; break; }
+			}
+			if (nAct[1] > 0) {
+				CTraceSpan tr1("insert", QString(), nAct[1]);
+				sql = "insert into " + m_tabcol->tab + " (" + cols + ") select " + cols + " from DbSyncStage where DbSyncOp='I'";
+				if (query.exec(sql) == false)					{ err = -24; break; }
+				if (query.numRowsAffected() != nAct[1])			{ err = -27; break; }
+			}
+		}
+		if (pdb->commit() == false)			{ err = -25; break; }
+		break;
+	}
+
+	if (err != 0) {
+		QString x1 = (err == -27) ? QString("the changed rows don't match the keys (%1)").arg(query.numRowsAffected()) :
+					 (errTxt.isEmpty() == false) ? errTxt : query.lastError().text();
+		x1 = x1.trimmed().replace("\n", "; ");
+		printf("Set apply error: %s\n", qPrintable(x1));
+		printf("The set is rolled back, the rows are changed one by one.\n");
+		AddLog(m_tabcol, "Err: " + x1, false);
+		AddLog(m_tabcol, "SQL: " + sql, false);
+		AddLog(m_tabcol, "     ");
+		pdb->rollback();
+	}
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+// change the rows of the destination db (by sections: different, unnecessary, missing)
+int ApplyActions (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, linetab* headS, linetab* headD, journal* jr)
+{
+	CTraceSpan tr("apply", m_tabcol->tab, jr->acts.size());
+	bool bChngeTrg = IsRecovery (m_tabcol);
+	SyncTriggers (pdb, SqlDrv, m_tabcol, bChngeTrg, false);
+
+	int setState = 0;	// 1 - the changes are applied by the set, 2 - the set is declined
+	if (IsSetApply(m_tabcol, SqlDrv) == true && m_tabcol->bIgnAll == false && m_tabcol->bKeyGuard == false && IsThrottle(m_tabcol) == false) {
+		int r = ApplySet (pdb, m_tabcol, headS, headD, jr);
+		setState = (r == 0) ? 1 : (r == 1) ? 2 : 0;
+	}
+
+	// libpq pipeline: the rows are sent w/o waiting, the results - by batches
+	CPgPipe pipe;
+	bool bAsync = setState == 0 && IsAsyncApply(m_tabcol, SqlDrv) == true && m_tabcol->bIgnAll == false &&
+				  m_tabcol->bKeyGuard == false && IsThrottle(m_tabcol) == false && pipe.Begin(pdb) == true;
+
+	const char* section[3] = { "- Different Rows (source DB):", "- Unnecessary Rows (destination DB):", "- Missing Rows (source DB):" };
+	int nSect = 0;
+
+	int err = 0;
+	int DuplicateRows = jr->Identical, DifferentRows = 0, UnnecessRows = 0, MissingRows = 0;
+	for (int k = 0; k <= jr->acts.size(); k++) {
+		if (bAsync == true && (k == jr->acts.size() || pipe.batch.size() >= m_tabcol->asyncBatch)) {
+			QList<pipestmt> done;
+			err += AsyncFlush (&pipe, m_tabcol, done);
+			for (int d = 0; d < done.size(); d++) {		// the rows were counted as not changed
+				DuplicateRows++;
+				if      (done.at(d).mode == 2)	DifferentRows--;
+				else if (done.at(d).mode == 0)	UnnecessRows--;
+				else							MissingRows--;
+				JournalMark (jr, done.at(d).indx, JRN_APPLIED);
+			}
+		}
+
+		int sect = (k == jr->acts.size()) ? 3 : (jr->acts.at(k).mode == 2) ? 0 : (jr->acts.at(k).mode == 0) ? 1 : 2;
+		for (; nSect <= sect && nSect < 3; nSect++) {
+			AddLog(m_tabcol, QString("-----------------------------------------"));
+			AddLog(m_tabcol, QString(section[nSect]));
+		}
+		if (k == jr->acts.size())
+			break;
+
+		const rowact& act = jr->acts.at(k);
+		if (k < jr->state.size() && jr->state.at(k) == JRN_APPLIED) {	// resume: committed earlier
+			DuplicateRows++;
+			continue;
+		}
+
+		int nChangeRow = 1;
+		bool bDone = false;
+		int err0 = ApplyRowAct (pdb, SqlDrv, m_tabcol, headS, headD, act, false, bDone, setState, (bAsync == true) ? &pipe : nullptr, k);
+		if (bDone == true) {
+			DuplicateRows++;  nChangeRow = 0;
+			JournalMark (jr, k, JRN_APPLIED);
+		}
+		else if (err0 == -26) {		// resume: the row isn't the same
+			QString tt = "  The row was changed after the journal. Skipped.";
+			printf ("%s\n", qPrintable(tt));
+			AddLog(m_tabcol, tt);
+			JournalMark (jr, k, JRN_STALE);
+		}
+		else {
+			err += err0;
+		}
+
+		if      (act.mode == 2)	DifferentRows += nChangeRow;
+		else if (act.mode == 0)	UnnecessRows  += nChangeRow;
+		else					MissingRows   += nChangeRow;
+	}
+	pipe.End();
+
+	SyncTriggers (pdb, SqlDrv, m_tabcol, bChngeTrg, true);
+	PrintTotals  (m_tabcol, bChngeTrg, DuplicateRows, DifferentRows, UnnecessRows, MissingRows, err);
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+// the rows are compared in several threads: the rows are divided into buckets by the key,
+// the same rows (crc) and the rows with the same key are always in the same bucket
+#define ROWS_BUCKET		2000		// rows (Src+Dst) in one bucket, about
+
+typedef struct _rowbucket
+{
+	QVector<int>	rowS, rowD;		// rows of the bucket (index in the table)
+
+} rowbucket;
+
+//-------------------------------------------------------------------------------------------------
+// rows of one bucket: the same search as for the whole table.
+// stS, stD - mode of the row (rowact) or -1 (identical), pairD - destination row of different row
+void GetBucketActs (tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD, const rowbucket* pb, int* stS, int* stD, int* pairD)
+{
+	QVector<int> rS = pb->rowS, rD = pb->rowD;
+
+	// search & ignore duplicate rows
+	for (int i = 0; i < rS.size(); i++) {
+		const QString& crcS = m_linesS->m_crcline.at(rS.at(i));
+
+		for (int j = 0; j < rD.size(); j++) {
+			if (m_linesD->m_crcline.at(rD.at(j)) != crcS) continue; // it isn't same row
+
+			stS[rS.at(i)] = -1;	stD[rD.at(j)] = -1;
+			rS.removeAt(i);		rD.removeAt(j);
+			i--;
+			break;
+		}
+	}
+
+	// search different rows
+	for (int i = 0; i < rS.size() && rD.size() > 0; i++) {
+		const rowkey& keyS = m_linesS->m_keyline.at(rS.at(i));  // source
+
+		for (int j = 0; j < rD.size(); j++) {
+			if (keyS != m_linesD->m_keyline.at(rD.at(j)))	// !same row, but... (2022 this is Unnecessary or Missing - key1 != key2)
+				continue;
+
+			// this is diff row (key1==key2)
+			stS[rS.at(i)] = 2;	stD[rD.at(j)] = -1;	pairD[rS.at(i)] = rD.at(j);
+			rS.removeAt(i);		rD.removeAt(j);
+			i--;
+			break;
+		}
+	}
+
+	for (int j = 0; j < rD.size(); j++)	stD[rD.at(j)] = 0;	// unwanted rows
+	for (int i = 0; i < rS.size(); i++)	stS[rS.at(i)] = 1;	// missing rows
+}
+
+//-------------------------------------------------------------------------------------------------
+class CBucketThread : public QThread	// buckets by turns
+{
+public:
+	void run() override
+	{
+#ifdef CRASH_ON
+		crInstallToCurrentThread2(0);
+#endif
+		TraceThread ("compare");
+		CTraceSpan tr("compare buckets", QString(), 0);
+		for (;;) {
+			int k = pNext->fetchAndAddOrdered(1);
+			if (k >= nBucket)
+				break;
+			GetBucketActs (m_tabcol, m_linesS, m_linesD, pBucket + k, stS, stD, pairD);
+			tr.n += pBucket[k].rowS.size() + pBucket[k].rowD.size();
+		}
+#ifdef CRASH_ON
+		crUninstallFromCurrentThread();
+#endif
+	}
+
+	tabcol*		m_tabcol = nullptr;
+	linetab*	m_linesS = nullptr;
+	linetab*	m_linesD = nullptr;
+	const rowbucket* pBucket = nullptr;
+	int			nBucket	= 0;
+	QAtomicInt*	pNext	= nullptr;
+	int			*stS = nullptr, *stD = nullptr, *pairD = nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------
+// rows to change: identical rows are removed from the lists, the rest are classified by key
+// (the order of the rows is the same as for one thread)
+int GetRowActs (tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD, QList<rowact>& acts)
+{
+	int nS = m_linesS->m_tabdata.size(), nD = m_linesD->m_tabdata.size();
+	CTraceSpan tr("compare", QString(), nS + nD);
+	int nThr	= qBound(1, QThread::idealThreadCount(), 64);
+	int nBucket	= (nS + nD) / ROWS_BUCKET + 1;
+	if (nBucket > 1 && nBucket < nThr * 4)
+		nBucket = nThr * 4;		// by turns: the buckets aren't the same
+	if (nBucket == 1)
+		nThr = 1;
+
+	// the keys of both tables must have the same form (else - text of the columns)
+	if (m_linesS->m_keyline.size() != nS || m_linesD->m_keyline.size() != nD ||
+		(nS > 0 && nD > 0 && m_linesS->m_keyKind != m_linesD->m_keyKind)) {
+		bool bText = (m_linesS->m_typeCol.size() > 0 && m_linesD->m_typeCol.size() > 0 &&
+					  GetKeyKind(m_linesS->m_typeCol, m_tabcol->poskey, false) != GetKeyKind(m_linesD->m_typeCol, m_tabcol->poskey, false));
+		SetRowKeys (m_linesS, m_tabcol->poskey, bText);
+		SetRowKeys (m_linesD, m_tabcol->poskey, bText);
+	}
+
+	QVector<rowbucket> bucket(nBucket);
+	for (int i = 0; i < nS && nBucket > 1; i++)
+		bucket[qHash(m_linesS->m_keyline.at(i)) % nBucket].rowS.append(i);
+	for (int j = 0; j < nD && nBucket > 1; j++)
+		bucket[qHash(m_linesD->m_keyline.at(j)) % nBucket].rowD.append(j);
+	if (nBucket == 1) {
+		for (int i = 0; i < nS; i++)	bucket[0].rowS.append(i);
+		for (int j = 0; j < nD; j++)	bucket[0].rowD.append(j);
+	}
+
+	QVector<int> stS(nS, 1), stD(nD, 0), pairD(nS, -1);
+	if (nThr == 1) {	// small table
+		for (int k = 0; k < nBucket; k++)
+			GetBucketActs (m_tabcol, m_linesS, m_linesD, &bucket.at(k), stS.data(), stD.data(), pairD.data());
+	}
+	else {
+		QAtomicInt next;
+		QVector<CBucketThread*> thr;
+		for (int t = 0; t < nThr; t++) {
+			CBucketThread* p = new CBucketThread;
+			p->m_tabcol = m_tabcol;	p->m_linesS = m_linesS;	p->m_linesD = m_linesD;
+			p->pBucket	= bucket.constData();	p->nBucket = nBucket;	p->pNext = &next;
+			p->stS		= stS.data();	p->stD = stD.data();	p->pairD = pairD.data();
+			thr.append(p);
+		}
+		for (int t = 0; t < nThr; t++)	thr.at(t)->start();
+		for (int t = 0; t < nThr; t++)	thr.at(t)->wait();
+		qDeleteAll(thr);
+	}
+
+	// different rows, unwanted rows, missing rows
+	int DuplicateRows = 0;
+	for (int i = 0; i < nS; i++) {
+		if (stS.at(i) == -1)	DuplicateRows++;
+		if (stS.at(i) != 2)		continue;
+		rowact act; act.mode = 2;
+		act.rowS = m_linesS->m_tabdata.at(i);
+		act.rowD = m_linesD->m_tabdata.at(pairD.at(i));
+		acts.append(act);
+	}
+	for (int j = 0; j < nD; j++) {
+		if (stD.at(j) != 0)		continue;
+		rowact act; act.mode = 0;
+		act.rowD = m_linesD->m_tabdata.at(j);
+		acts.append(act);
+	}
+	for (int i = 0; i < nS; i++) {
+		if (stS.at(i) != 1)		continue;
+		rowact act; act.mode = 1;
+		act.rowS = m_linesS->m_tabdata.at(i);
+		acts.append(act);
+	}
+
+	// the rest of the lists: missing (Src) & unwanted (Dst) rows
+	linetab restS = GetHead(m_linesS), restD = GetHead(m_linesD);
+	for (int i = 0; i < nS; i++)
+		if (stS.at(i) == 1) { restS.m_crcline.append(m_linesS->m_crcline.at(i)); restS.m_tabdata.append(m_linesS->m_tabdata.at(i)); restS.m_keyline.append(m_linesS->m_keyline.at(i)); }
+	for (int j = 0; j < nD; j++)
+		if (stD.at(j) == 0) { restD.m_crcline.append(m_linesD->m_crcline.at(j)); restD.m_tabdata.append(m_linesD->m_tabdata.at(j)); restD.m_keyline.append(m_linesD->m_keyline.at(j)); }
+	m_linesS->m_crcline = restS.m_crcline;	m_linesS->m_tabdata = restS.m_tabdata;	m_linesS->m_keyline = restS.m_keyline;
+	m_linesD->m_crcline = restD.m_crcline;	m_linesD->m_tabdata = restD.m_tabdata;	m_linesD->m_keyline = restD.m_keyline;
+	return DuplicateRows;
+}
+
+//-------------------------------------------------------------------------------------------------
+int SaveErr (QSqlQuery* p, QString sql, tabcol*	m_tabcol, int err)
+{
+	QString x1 = p->lastError().text().replace("\n", "; ");
+	printf ("SQL execution error: %s\n", qPrintable(x1));
+	AddLog(m_tabcol, "Err: " + x1 ,false);
+	AddLog(m_tabcol, "SQL: " + sql,false);
+	AddLog(m_tabcol, " ");
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+void GetColTypes (const QSqlRecord& rec, linetab* m_lines)	// columns name & type of the query
+{
+	for (int n = 0; n < rec.count(); n++)	{
+		QSqlField  oField	= rec.field(n);
+		QString    nname	= oField.name();
+		QVariant   vartype	= oField.type();
+		int			precis	= oField.precision();
+		int			typeCol =(int)vartype.type();
+		if (typeCol == (int)QVariant::Double && precis <= 0)
+				typeCol = QVariant::Int;
+
+		m_lines->m_nameCol.append(nname);
+		m_lines->m_typeCol.append(typeCol);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+int GetColProbe (QSqlDatabase* pdb, tabcol* m_tabcol, QSqlRecord& rec)	// columns of the table (empty result)
+{
+	QString cols = "";
+	for (int i = 0; i < m_tabcol->col.size(); i++) {
+		if (i > 0)	cols += ",";
+		cols += m_tabcol->col.at(i).trimmed();
+	}
+
+	QString sqlt  = "select " + cols + " from " + m_tabcol->tab + " where 1=0";
+	QSqlQuery query0(*pdb);
+	if (query0.exec(sqlt) == false)
+		return SaveErr (&query0, sqlt, m_tabcol, -41);
+
+	rec = query0.record();
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+QSql::NumericalPrecisionPolicy GetNumPolicy (const QSqlRecord& rec)	// integer numbers w/o strings of the driver
+{
+	bool bNumber = false;
+	for (int n = 0; n < rec.count(); n++) {
+		QSqlField oField = rec.field(n);
+		if (oField.type() != QVariant::Double)
+			continue;
+		if (oField.precision() != 0 || oField.length() <= 0 || oField.length() > 18)
+			return QSql::HighPrecision;	// decimal or big numbers: exact text of the driver
+		bNumber = true;
+	}
+	return (bNumber == true) ? QSql::LowPrecisionInt64 : QSql::HighPrecision;
+}
+
+//-------------------------------------------------------------------------------------------------
+// queue of the blocks between two threads (pipeline, asynchronous reading)
+#define PIPE_QUEUE	4			// blocks in one queue (backpressure)
+
+template <class T> class CPipeQueue
+{
+public:
+	bool Put (const T& item) {		// waits while the queue is full; false - pipeline is aborted
+		QMutexLocker lock(&mtx);
+		while (items.size() >= PIPE_QUEUE && bAbort == false)
+			notFull.wait(&mtx);
+		if (bAbort == true)
+			return false;
+		items.enqueue(item);
+		notEmpty.wakeOne();
+		return true;
+	}
+	bool Get (T& item) {			// waits while the queue is empty; false - end of data or pipeline is aborted
+		QMutexLocker lock(&mtx);
+		while (items.isEmpty() == true && bClosed == false && bAbort == false)
+			notEmpty.wait(&mtx);
+		if (bAbort == true || items.isEmpty() == true)
+			return false;
+		item = items.dequeue();
+		notFull.wakeOne();
+		return true;
+	}
+	void Close () { QMutexLocker lock(&mtx); bClosed = true; notEmpty.wakeAll(); }	// producer has finished
+	void Abort () { QMutexLocker lock(&mtx); bAbort  = true; notEmpty.wakeAll(); notFull.wakeAll(); }
+	QList<T> TakeAll () { QMutexLocker lock(&mtx); QList<T> r = items; items.clear(); return r; }	// rest of the aborted queue
+
+private:
+	QMutex			mtx;
+	QWaitCondition	notFull;
+	QWaitCondition	notEmpty;
+	QQueue<T>		items;
+	bool			bClosed = false;
+	bool			bAbort  = false;
+};
+
+//-------------------------------------------------------------------------------------------------
+// rows of the query: forward only (w/o cache of Qt). PostgreSQL: by the cursor of the server
+// (FETCH n), so libpq keeps one part of the rows only and the first rows come at once
+#define CURSOR_FETCH	5000		// rows in one FETCH
+
+class CRowReader
+{
+public:
+	CRowReader (QSqlDatabase* pdb) : query(*pdb), pDb(pdb) {}
+	~CRowReader () { Close(); }
+
+	bool Exec (QString SqlDrv, QString sql, QSql::NumericalPrecisionPolicy numPolicy)
+	{
+		CTraceSpan tr("query", sql);
+		query.setForwardOnly(true);
+		query.setNumericalPrecisionPolicy(numPolicy);
+		if (SqlDrv != "QPSQL")
+			return query.exec(sql);
+
+		if (bInTrans == false) {
+			if (pDb->transaction() == false) {	// the cursor exists in the transaction only
+				err = pDb->lastError().text();
+				return false;
+			}
+			bCursor = true;
+			if (snapshot.isEmpty() == false &&	// the same point in time as the other readers
+				(query.exec("set transaction isolation level repeatable read") == false ||
+				 query.exec("set transaction snapshot '" + snapshot + "'") == false))
+				return false;
+		}
+		bCursor = true;
+		if (query.exec("declare DbSyncCursor no scroll cursor for " + sql) == false)
+			return false;
+		return Fetch();
+	}
+	bool Next ()
+	{
+		if (query.next() == true) {
+			nRows++;
+			return true;
+		}
+		if (bCursor == false || nRows < CURSOR_FETCH || query.lastError().isValid() == true)
+			return false;
+		return Fetch() && Next();	// the next part of the rows
+	}
+	void Close ()
+	{
+		if (bCursor == false)
+			return;
+		bCursor = false;
+		query.finish();
+		if (bInTrans == true)	query.exec("close DbSyncCursor");	// the transaction of the snapshot is kept
+		else					pDb->rollback();	// read only, the cursor is closed
+	}
+
+	QVariant	value (int n)	{ return query.value(n); }
+	QSqlRecord	record ()		{ return query.record(); }
+	QString		error ()		{ return (err.isEmpty() == false) ? err : query.lastError().text(); }
+	bool		isError ()		{ return err.isEmpty() == false || query.lastError().isValid() == true; }
+
+	QString		snapshot = "";		// QPSQL: exported snapshot of the reading
+	bool		bInTrans = false;	// QPSQL: the transaction is open (the exporter of the snapshot)
+
+private:
+	bool Fetch ()
+	{
+		CTraceSpan tr("fetch", QString(), CURSOR_FETCH);
+		nRows = 0;
+		return query.exec(QString("fetch %1 from DbSyncCursor").arg(CURSOR_FETCH));
+	}
+
+	QSqlQuery		query;
+	QSqlDatabase*	pDb		= nullptr;
+	bool			bCursor	= false;
+	int				nRows	= 0;	// rows of the last FETCH
+	QString			err		= "";
+};
+
+//-------------------------------------------------------------------------------
+//
+class CMyDbThread : public QThread
+{
+public:
+	CMyDbThread (QObject *parent = NULL) : QThread(parent) { //-V730
+		pDb = nullptr;
+	}
+	void run() override
+	{
+#ifdef CRASH_ON
+		crInstallToCurrentThread2(0);
+#endif
+		TraceThread (QString("read #%1").arg(Instance));
+		QElapsedTimer timer;
+		timer.start();
+		CRowReader query(pDb);
+		query.snapshot = snapshot;
+		query.bInTrans = bSnapOwner;
+		bool b = query.Exec(SqlDrv, tsql, numPolicy);
+		if (b == false) {
+			// return SaveErr (&query, cnttest, m_tabcol, -31);
+			CodeErr = 1;
+			DbErr	= query.error().replace("\n", "; ");
+#ifdef CRASH_ON
+			crUninstallFromCurrentThread();
+#endif
+			return;
+		}
+
+		QSqlRecord rec = query.record();
+		int  cntField  = rec.count();
+		GetColTypes (rec, &m_lines);
+		m_lines.m_codec   = GetRowCodec (m_lines.m_typeCol);	// once per table
+		m_lines.m_keyKind = GetKeyKind  (m_lines.m_typeCol, poskey, false);
+
+		m_lines.m_tabdata.reserve(maxRow);
+		m_lines.m_crcline.reserve(maxRow);
+		m_lines.m_keyline.reserve(maxRow);
+
+		// read records
+		CTraceSpan tr("read & hash rows");
+		CRowHasher hasher;
+		rowkey key;
+		while (query.Next())	{
+			QVariantList mvlist;
+			mvlist.reserve(cntField);
+			for (int n = 0; n < cntField; n++)
+				mvlist.append(query.value(n));
+		
+			GetRowKey (&m_lines, poskey, mvlist, key);
+			m_lines.m_keyline.append( key );
+			m_lines.m_tabdata.append( mvlist );
+			if (posCrc < 0)
+				hasher.Add (mvlist, m_lines.m_codec, &m_lines.m_crcline);
+			else if (mvlist.at(posCrc).isNull() == false)
+				m_lines.m_crcline.append(mvlist.at(posCrc).toString());
+			else	// w/o stored checksum: unique (the row is compared by all columns)
+				m_lines.m_crcline.append(QString("null %1").arg(nullCrc.fetchAndAddOrdered(1)));
+		} 
+		if (posCrc < 0)
+			hasher.Flush (&m_lines.m_crcline);
+		tr.n = m_lines.m_tabdata.size();
+
+		if (query.isError() == true) {	// the connection is broken in the middle of the data
+			CodeErr = 1;
+			DbErr	= query.error().replace("\n", "; ");
+#ifdef CRASH_ON
+			crUninstallFromCurrentThread();
+#endif
+			return;
+		}
+
+		m_lines.b_Unsuppt	= (m_lines.m_codec.ColUnsupp > 0 && m_lines.m_tabdata.size() > 0);
+		m_lines.ColUnsupp	= m_lines.m_codec.ColUnsupp;
+		CodeErr				= 0;
+		ms					= timer.elapsed();
+#ifdef CRASH_ON
+		crUninstallFromCurrentThread();
+#endif
+	}
+
+	QString		 tsql = "";
+	QString		 SqlDrv="";
+	QSqlDatabase* pDb = nullptr;
+	QSql::NumericalPrecisionPolicy numPolicy = QSql::HighPrecision;
+	QList<int>	 poskey;			// key columns
+	QString		 snapshot = "";		// QPSQL: the same snapshot for all readers
+	bool		 bSnapOwner=false;	// QPSQL: the connection has exported the snapshot
+	int		posCrc	  = -1;			// column of the stored checksum: the checksum of the row w/o hashing
+	int		Instance  = -1;
+	QString DbErr	  = "";
+	int		CodeErr	  = -101;
+	int		maxRow	  = 1;
+	qint64	ms		  = -1;			// time of the reading (client)
+	linetab	m_lines;
+	static QAtomicInt nullCrc;
+};
+
+QAtomicInt CMyDbThread::nullCrc;
+
+
+//-------------------------------------------------------------------------------------------------
+// one point in time for all reader connections. QPSQL: exported snapshot (the transaction of pdb
+// is open until the end of the reading), QOCI: flashback query by SCN
+int GetSnapshot (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, QString& snapshot, QString& asof)
+{
+	CTraceSpan tr("snapshot");
+	QSqlQuery query(*pdb);
+	if (SqlDrv == "QPSQL") {
+		if (pdb->transaction() == true) {
+			if (query.exec("set transaction isolation level repeatable read") == true &&
+				query.exec("select pg_export_snapshot()") == true && query.next() == true) {
+				snapshot = query.value(0).toString();
+				return 0;
+			}
+			pdb->rollback();
+		}
+	}
+	else
+	if (SqlDrv == "QOCI") {
+		if ((query.exec("select to_char(dbms_flashback.get_system_change_number) from dual") == true && query.next() == true) ||
+			(query.exec("select to_char(current_scn) from v$database") == true && query.next() == true)) {
+			asof = " as of scn " + query.value(0).toString();
+			return 0;
+		}
+	}
+
+	QString tt = "Warning ! Snapshot isn't set, the connections read different points in time: " + query.lastError().text().replace("\n", "; ");
+	printf ("%s\n", qPrintable(tt));
+	AddLog(m_tabcol, tt, false);
+	return -34;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline void EndSnapshot (QSqlDatabase* pdb, const QString& snapshot)	// close the transaction of the exported snapshot
+{
+	if (snapshot.isEmpty() == false)
+		pdb->rollback();
+}
+
+//-------------------------------------------------------------------------------------------------
+// asynchronous reading (QPSQL): one thread drives the connections of all parts (libpq: single row
+// mode, poll of the sockets), the blocks of the rows are hashed by a few workers as they arrive
+#define ASYNC_ROWS		1000		// rows in one block for the hashing
+
+typedef struct _asyncblock
+{
+	int				part = 0;		// CMyDbThread of the part (sql, connection, rows)
+	int				seq  = 0;		// number of the block in the part (order of the rows)
+	tabdata			rows;
+	QStringList		crc;
+	QVector<rowkey>	keys;
+
+} asyncblock;
+
+#ifdef LIBPQ_ON
+//-------------------------------------------------------------------------------------------------
+QVariant PgValue (const PGresult* res, int n, int type, QSql::NumericalPrecisionPolicy numPolicy)	// column data as the Qt driver (QPSQL)
+{
+	if (PQgetisnull(res, 0, n) == 1)
+		return QVariant((QVariant::Type)type);
+
+	const char* val = PQgetvalue(res, 0, n);
+	switch (type) {
+	case QVariant::Bool:		return QVariant((bool)(val[0] == 't'));
+	case QVariant::Int:			return QVariant(atoi(val));
+	case QVariant::LongLong:	return (val[0] == '-') ? QVariant(QString::fromLatin1(val).toLongLong()) : QVariant(QString::fromLatin1(val).toULongLong());
+	case QVariant::Double: {
+		bool bNumeric = (PQftype(res, n) == 1700);	// numeric
+		if (bNumeric == true && numPolicy == QSql::HighPrecision)
+			return QVariant(QString::fromLatin1(val));
+		bool   ok  = false;
+		double dbl = QString::fromLatin1(val).toDouble(&ok);
+		if (ok == false) {
+			if      (qstricmp(val, "NaN") == 0)			dbl = qQNaN();
+			else if (qstricmp(val, "Infinity") == 0)	dbl = qInf();
+			else if (qstricmp(val, "-Infinity") == 0)	dbl = -qInf();
+			else										return QVariant();
+		}
+		if (bNumeric == true && numPolicy == QSql::LowPrecisionInt64)	return QVariant((qlonglong)dbl);
+		if (bNumeric == true && numPolicy == QSql::LowPrecisionInt32)	return QVariant((int)dbl);
+		return QVariant(dbl);
+	}
+	case QVariant::Date:		return QVariant(QDate::fromString(QString::fromLatin1(val), Qt::ISODate));
+	case QVariant::Time:		return QVariant(QTime::fromString(QString::fromLatin1(val), Qt::ISODate));
+	case QVariant::DateTime: {
+		QString dt = QString::fromLatin1(val);
+		if (dt.length() < 10)
+			return QVariant(QDateTime());
+		QChar sign = dt.at(dt.size() - 3);
+		if (sign == QLatin1Char('-') || sign == QLatin1Char('+'))
+			dt += QLatin1String(":00");
+		return QVariant(QDateTime::fromString(dt, Qt::ISODate).toLocalTime());
+	}
+	case QVariant::ByteArray: {
+		size_t len = 0;
+		unsigned char* data = PQunescapeBytea((const unsigned char*)val, &len);
+		QByteArray ba((const char*)data, (int)len);
+		PQfreemem(data);
+		return QVariant(ba);
+	}
+	default:					return QVariant(QString::fromUtf8(val));
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+inline bool PgExec (PGconn* conn, const QString& sql, QString& err)	// statement w/o rows
+{
+	PGresult* res = PQexec(conn, sql.toUtf8().constData());
+	bool b = (PQresultStatus(res) == PGRES_COMMAND_OK);
+	if (b == false)
+		err = QString::fromUtf8(PQerrorMessage(conn)).trimmed().replace("\n", "; ");
+	PQclear(res);
+	return b;
+}
+#endif
+
+//-------------------------------------------------------------------------------------------------
+class CAsyncHash : public QThread	// checksums & keys of the blocks, the rows are added to the part
+{
+public:
+	void run() override
+	{
+#ifdef CRASH_ON
+		crInstallToCurrentThread2(0);
+#endif
+		TraceThread ("hash");
+		asyncblock b;
+		while (pQueue->Get(b) == true) {
+			CMyDbThread* pt = pParts + b.part;
+			CTraceSpan tr("hash", QString(), b.rows.size());
+			CRowHasher hasher;
+			b.keys.resize(b.rows.size());
+			for (int k = 0; k < b.rows.size(); k++) {
+				GetRowKey (&pt->m_lines, pt->poskey, b.rows.at(k), b.keys[k]);
+				hasher.Add (b.rows.at(k), pt->m_lines.m_codec, &b.crc);
+			}
+			hasher.Flush (&b.crc);
+
+			QMutexLocker lock(pMtx);
+			pDone[b.part].insert(b.seq, b);
+		}
+#ifdef CRASH_ON
+		crUninstallFromCurrentThread();
+#endif
+	}
+
+	CPipeQueue<asyncblock>*	pQueue	= nullptr;
+	CMyDbThread*			pParts	= nullptr;
+	QMap<int, asyncblock>*	pDone	= nullptr;	// hashed blocks of the parts (by seq)
+	QMutex*					pMtx	= nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------
+// the parts of GetDataTable (sql, connection & results of CMyDbThread) in the current thread.
+// false - the parts aren't read (other driver, w/o libpq): the threads are used
+bool ReadPartsAsync (CMyDbThread* pThr, int nPart, const QString& snapshot)
+{
+#ifdef LIBPQ_ON
+	QVector<PGconn*> conn(nPart);
+	for (int n = 0; n < nPart; n++)
+		if (pThr[n].SqlDrv != "QPSQL" || (conn[n] = GetPgConn(pThr[n].pDb)) == nullptr)
+			return false;
+
+	CTraceSpan tr("read async", QString(), nPart);
+	QVector<QList<int> > fieldType(nPart);		// types of the driver (QSqlField)
+	QVector<bool>        bActive(nPart, false), bTrans(nPart, false);
+	for (int n = 0; n < nPart; n++) {
+		CMyDbThread& pt = pThr[n];
+		pt.m_lines = linetab();
+		pt.CodeErr = 1;
+
+		// columns: the same types & codec as the reading by Qt
+		{
+			QSqlQuery probe(*pt.pDb);
+			probe.setNumericalPrecisionPolicy(pt.numPolicy);
+			if (probe.exec("select * from (" + pt.tsql + ") DbSyncProbe where 1=0") == false) {
+				pt.DbErr = probe.lastError().text().replace("\n", "; ");
+				continue;
+			}
+			QSqlRecord rec = probe.record();
+			for (int k = 0; k < rec.count(); k++)
+				fieldType[n].append((int)rec.field(k).type());
+			GetColTypes (rec, &pt.m_lines);
+			pt.m_lines.m_codec   = GetRowCodec (pt.m_lines.m_typeCol);
+			pt.m_lines.m_keyKind = GetKeyKind  (pt.m_lines.m_typeCol, pt.poskey, false);
+		}
+
+		// the snapshot of the other readers (the owner is in the transaction)
+		if (snapshot.isEmpty() == false && pt.bSnapOwner == false) {
+			bTrans[n] = PgExec(conn[n], "begin isolation level repeatable read", pt.DbErr);
+			if (bTrans[n] == false || PgExec(conn[n], "set transaction snapshot '" + snapshot + "'", pt.DbErr) == false)
+				continue;
+		}
+		if (PQsendQuery(conn[n], pt.tsql.toUtf8().constData()) != 1 || PQsetSingleRowMode(conn[n]) != 1) {
+			pt.DbErr = QString::fromUtf8(PQerrorMessage(conn[n])).trimmed().replace("\n", "; ");
+			continue;
+		}
+		pt.CodeErr = 0;
+		bActive[n] = true;
+	}
+
+	CPipeQueue<asyncblock> queue;
+	QVector<QMap<int, asyncblock> > done(nPart);
+	QMutex mtx;
+	QList<CAsyncHash*> hash;
+	for (int k = qBound(1, QThread::idealThreadCount() - 1, 8); k > 0; k--) {
+		CAsyncHash* p = new CAsyncHash;
+		p->pQueue = &queue; p->pParts = pThr; p->pDone = done.data(); p->pMtx = &mtx;
+		p->start();
+		hash.append(p);
+	}
+
+	QVector<asyncblock> block(nPart);
+	for (;;) {
+		QVector<pollfd> fds;
+		QVector<int>    fdPart;
+		for (int n = 0; n < nPart; n++) {
+			if (bActive.at(n) == false)
+				continue;
+			pollfd fd;
+			fd.fd		= PQsocket(conn[n]);
+			fd.events	= POLLIN;
+			fd.revents	= 0;
+			fds.append(fd);
+			fdPart.append(n);
+		}
+		if (fds.size() == 0)
+			break;
+#ifdef WIN32
+		WSAPoll(fds.data(), fds.size(), 1000);
+#else
+		poll(fds.data(), fds.size(), 1000);
+#endif
+
+		for (int f = 0; f < fds.size(); f++) {
+			if (fds.at(f).revents == 0)
+				continue;
+			int n = fdPart.at(f);
+			CMyDbThread& pt = pThr[n];
+			if (PQconsumeInput(conn[n]) == 0) {		// the connection is broken
+				pt.CodeErr = 1;
+				pt.DbErr   = QString::fromUtf8(PQerrorMessage(conn[n])).trimmed().replace("\n", "; ");
+				bActive[n] = false;
+				continue;
+			}
+			while (bActive.at(n) == true && PQisBusy(conn[n]) == 0) {
+				PGresult* res = PQgetResult(conn[n]);
+				if (res == nullptr) {		// end of the part
+					bActive[n] = false;
+					break;
+				}
+				ExecStatusType st = PQresultStatus(res);
+				if (st == PGRES_SINGLE_TUPLE) {
+					int cntField = PQnfields(res);
+					QVariantList vl;
+					vl.reserve(cntField);
+					for (int k = 0; k < cntField; k++)
+						vl.append(PgValue(res, k, fieldType.at(n).at(k), pt.numPolicy));
+					block[n].rows.append(vl);
+					if (block.at(n).rows.size() >= ASYNC_ROWS) {
+						block[n].part = n;
+						queue.Put(block.at(n));
+						block[n].rows.clear();
+						block[n].seq++;
+					}
+				}
+				else
+				if (st != PGRES_TUPLES_OK && pt.CodeErr == 0) {
+					pt.CodeErr = 1;
+					pt.DbErr   = QString::fromUtf8(PQresultErrorMessage(res)).trimmed().replace("\n", "; ");
+				}
+				PQclear(res);
+			}
+		}
+	}
+
+	for (int n = 0; n < nPart; n++) {	// the rest of the rows
+		if (block.at(n).rows.size() == 0)
+			continue;
+		block[n].part = n;
+		queue.Put(block.at(n));
+	}
+	queue.Close();
+	for (int k = 0; k < hash.size(); k++)	hash.at(k)->wait();
+	qDeleteAll(hash);
+
+	for (int n = 0; n < nPart; n++) {
+		CMyDbThread& pt = pThr[n];
+		QString err;
+		if (bTrans.at(n) == true)
+			PgExec(conn[n], "rollback", err);
+		if (pt.CodeErr != 0)
+			continue;
+		for (QMap<int, asyncblock>::const_iterator it = done.at(n).constBegin(); it != done.at(n).constEnd(); ++it) {
+			pt.m_lines.m_tabdata.append(it.value().rows);
+			pt.m_lines.m_crcline.append(it.value().crc);
+			pt.m_lines.m_keyline += it.value().keys;
+		}
+		pt.m_lines.b_Unsuppt = (pt.m_lines.m_codec.ColUnsupp > 0 && pt.m_lines.m_tabdata.size() > 0);
+		pt.m_lines.ColUnsupp = pt.m_lines.m_codec.ColUnsupp;
+	}
+	return true;
+#else
+	Q_UNUSED(pThr); Q_UNUSED(nPart); Q_UNUSED(snapshot);
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+#define READ_PAUSE_MAX	30000		// max pause before the next attempt of the reading, msec
+
+void ReadPartAgain (CMyDbThread* pt, int pause)	// the part of the table on a new connection
+{
+	CTraceSpan tr("read again", QString(), pause);
+	QThread::msleep(pause);
+	pt->pDb->close();
+	if (pt->pDb->open() == false) {
+		pt->DbErr = pt->pDb->lastError().text().replace("\n", "; ");
+		return;
+	}
+	pt->m_lines = linetab();
+	pt->CodeErr = -101;
+	pt->start();
+	pt->wait();
+}
+
+//-------------------------------------------------------------------------------------------------
+// reading data in multiple threads.
+int GetDataTable(QList<QSqlDatabase*> m_db, QString SqlDrv, tabcol*	m_tabcol, linetab* m_lines)
+{
+	int    maxConnect = m_db.size();
+	QSqlDatabase* pdb = m_db.at(0);				// for simple queries
+	QString nameRID	  = "DbSyncExtentKeyId";	// Aliases for special database fields. 
+	QString nameRNM	  = "DbSyncExtentRowNum";	// Must be unique, do not match table fields
+
+	// parallel reading: the count and all parts of the rows are read from the same snapshot
+	QString snapshot = "", asof = "";
+	if (maxConnect > 1)
+		GetSnapshot (pdb, SqlDrv, m_tabcol, snapshot, asof);
+
+	// get rows count
+	QString cnttest = "select count(*) from " + m_tabcol->tab + asof;
+	m_tabcol->where = m_tabcol->where.trimmed();
+	if (m_tabcol->where.isEmpty() == false) {
+		cnttest += " where ";
+		cnttest += m_tabcol->where;
+	}	
+
+	// for debug
+	if (m_tabcol->bDebug == true) AddLog(m_tabcol, "  " + cnttest, false);
+
+	CTraceSpan trc("count", cnttest);
+	QElapsedTimer timeCnt;
+	timeCnt.start();
+	QSqlQuery query0(*pdb);						// execute sql
+	bool b = query0.exec(cnttest);
+	if (b == false && asof.isEmpty() == false) {	// flashback isn't allowed
+		QString tt = "Warning ! Flashback query error, the connections read different points in time: " + query0.lastError().text().replace("\n", "; ");
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt, false);
+		cnttest.replace(asof, "");
+		asof = "";
+		b = query0.exec(cnttest);
+	}
+	if (b == false) {
+		EndSnapshot (pdb, snapshot);
+		return SaveErr (&query0, cnttest, m_tabcol, -33);
+	}
+		
+	int cnt_rows = 0;
+	if (query0.next())							// read records
+		cnt_rows = query0.value(0).toInt();
+	qint64 msCnt = timeCnt.elapsed();
+
+	printf ("Rows count: %d\n", cnt_rows);
+
+	QSqlRecord recProbe;
+	if (GetColProbe(pdb, m_tabcol, recProbe) != 0) {
+		EndSnapshot (pdb, snapshot);
+		return -41;
+	}
+	QSql::NumericalPrecisionPolicy numPolicy = GetNumPolicy(recProbe);
+
+	if (snapshot.isEmpty() == false)	printf ("Read  data: start (snapshot %s)\n", qPrintable(snapshot));
+	else
+	if (asof.isEmpty() == false)		printf ("Read  data: start (%s)\n", qPrintable(asof.trimmed()));
+	else								printf ("Read  data: start\n");
+
+	//-----------------------------
+	QString sql0;
+	int n_beg = 0, n_end = 0, n_step = 1;
+	if (maxConnect == 1) {
+		// old postgresql
+		sql0= "select ";
+		for (int i = 0; i < m_tabcol->col.size(); i++) {
+			sql0 +=        m_tabcol->col.at(i).trimmed() + ",";
+		}
+
+		if (SqlDrv == "QOCI") {
+			sql0 += "t.rowid " + nameRID ;	// to access the row to update
+		} else
+		if (SqlDrv == "QPSQL") {
+			sql0 += "ctid as " + nameRID;
+		} else {
+			printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
+			return -30;	// w/o rowid !!!
+		}
+		sql0 += " from " + m_tabcol->tab;
+
+		if (m_tabcol->where.isEmpty() == false) {
+			sql0 += " where ";
+			sql0 += m_tabcol->where;
+		}
+
+		n_step= cnt_rows;
+	}
+	else {
+		// 
+		// multi processing - prepare requests for several threads
+		QString sql1= "";
+		QString sql2= "";
+		QString sqlw= "";
+		for (int i = 0; i < m_tabcol->col.size(); i++) {
+			sql1 +=        m_tabcol->col.at(i).trimmed() + ",";
+			sql2 += "t." + m_tabcol->col.at(i).trimmed() + ",";
+		}
+		sql1 += nameRID;
+
+		if (SqlDrv == "QOCI") {
+			sql2 += "t.rowid " + nameRID + ", ";	// to access the row to update
+			sql2 += "rownum " + nameRNM + " ";		// to fetch a specific piece of data (part of select)
+			sqlw  = "t.rowid";						// data acquisition identity
+		} else
+		if (SqlDrv == "QPSQL") {
+			sql2 += "ctid as " + nameRID + ", ";
+			sql2 += "row_number() over() as " + nameRNM + " ";
+			sqlw  = "ctid";
+		} else {
+			printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
+			EndSnapshot (pdb, snapshot);
+			return -30;	// w/o rowid !!!
+		}
+
+		sql0  = "select ";
+		sql0 += sql1;
+		sql0 += " from (select ";
+		sql0 += sql2;
+		sql0 += " from " + m_tabcol->tab + asof;
+		sql0 += " t ";
+		if (m_tabcol->where.isEmpty() == false) {
+			sql0 += " where ";
+			sql0 += m_tabcol->where;
+		}
+		sql0 += " order by ";
+		sql0 += sqlw;
+		sql0 += ") ";
+
+		if (SqlDrv == "QPSQL") {	// fix Postgresql - alias for:  FROM (SELECT ...) [AS] foo
+			sql0 += "as DbSyncCursorTable ";
+		}
+
+		n_beg = 0; n_end = 0; n_step = 10 + cnt_rows / maxConnect;
+		n_step = (n_step / 10) * 10;
+
+		if (cnt_rows / maxConnect <= 10) {				// little data = 1 thread
+			maxConnect = 1;
+			n_step     = 10 + cnt_rows;
+		}
+	}
+
+	CMyDbThread pThr[22];							// max 10 thread (protected)
+	for (int n = 0; n < maxConnect; n++) {			// threads get data in parts from the all rows: 1..10, 11..20, 21..30 and etc.
+
+		QString ssql= sql0;
+		if (maxConnect != 1) {
+			n_end		= n_beg + n_step;			// so the database client loads the entire network channel			
+			if (n < maxConnect - 1)	ssql += QString ("where %1>=%2 and %3<%4").arg(nameRNM).arg (n_beg).arg(nameRNM).arg (n_end);
+			else					ssql += QString ("where %1>=%2").arg(nameRNM).arg (n_beg);
+		}
+		else {
+		}
+
+		n_beg			= n_end;
+		pThr[n].tsql	= ssql;
+		pThr[n].pDb		= m_db.at(n);
+		pThr[n].SqlDrv	= SqlDrv;
+		pThr[n].numPolicy=numPolicy;
+		pThr[n].poskey	= m_tabcol->poskey;
+		pThr[n].snapshot= snapshot;
+		pThr[n].bSnapOwner = (snapshot.isEmpty() == false && m_db.at(n) == pdb);
+		pThr[n].Instance= n;
+		pThr[n].maxRow	= 1.5 * n_step;
+	}
+
+	char txtTime[99];
+	QDateTime timeSql = QDateTime::currentDateTime();
+
+	{
+		CTraceSpan tr("read table", m_tabcol->tab, cnt_rows);
+		if (m_tabcol->bAsyncRead == false || ReadPartsAsync(pThr, maxConnect, snapshot) == false) {
+			for (int nn=0; nn < maxConnect; nn++) 	pThr[nn].start();	
+			for (int nn=0; nn < maxConnect; nn++)	pThr[nn].wait();	// waiting for all threads
+		}
+	}
+
+	// the failed parts are read again on a new connection (pause 1, 2, 4 ... sec), the rest is kept.
+	// the snapshot is closed with the connection of its owner: a new snapshot, all parts are read again
+	int nAttempt = 0, nFailed = 0;
+	for (int a = 1; a <= m_tabcol->readRetry; a++) {
+		bool bOwner = false;
+		QList<int> failed;
+		for (int nn = 0; nn < maxConnect; nn++) {
+			if (pThr[nn].CodeErr == 0)
+				continue;
+			QString tt = QString("  Read part #%1 error (attempt %2 of %3): %4").arg(nn + 1).arg(a).arg(m_tabcol->readRetry + 1).arg(pThr[nn].DbErr);
+			printf ("%s\n", qPrintable(tt));
+			AddLog(m_tabcol, tt, false);
+			if (pThr[nn].bSnapOwner == true)
+				bOwner = true;
+			failed.append(nn);
+		}
+		if (failed.size() == 0)
+			break;
+
+		if (bOwner == false) {
+			for (int k = 0; k < failed.size(); k++) {
+				nAttempt++;
+				ReadPartAgain (&pThr[failed.at(k)], (k == 0) ? qMin(1000 << qMin(a - 1, 5), READ_PAUSE_MAX) : 0);
+			}
+			continue;
+		}
+
+		QString tt = "  Warning ! Snapshot is lost, all parts are read again.";
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt, false);
+		QThread::msleep(qMin(1000 << qMin(a - 1, 5), READ_PAUSE_MAX));
+		for (int k = 0; k < failed.size(); k++)
+			pThr[failed.at(k)].pDb->close();
+		QString asof0 = "";
+		snapshot = "";
+		if (pdb->isOpen() == true || pdb->open() == true)
+			GetSnapshot (pdb, SqlDrv, m_tabcol, snapshot, asof0);
+		for (int nn = 0; nn < maxConnect; nn++) {
+			CMyDbThread& pt = pThr[nn];
+			pt.snapshot   = snapshot;
+			pt.bSnapOwner = (snapshot.isEmpty() == false && pt.pDb == pdb);
+			pt.m_lines    = linetab();
+			pt.CodeErr    = -101;
+			if (pt.pDb->isOpen() == false && pt.pDb->open() == false) {
+				pt.CodeErr = 1;
+				pt.DbErr   = pt.pDb->lastError().text().replace("\n", "; ");
+			}
+		}
+		nAttempt += maxConnect;
+		for (int nn = 0; nn < maxConnect; nn++)	if (pThr[nn].CodeErr == -101)	pThr[nn].start();
+		for (int nn = 0; nn < maxConnect; nn++)	pThr[nn].wait();
+	}
+	for (int nn = 0; nn < maxConnect; nn++)
+		if (pThr[nn].CodeErr != 0)
+			nFailed++;
+	if (nAttempt > 0) {
+		QString tt = QString("  Read parts: %1 of %2 failed, %3 attempts again").arg(nFailed).arg(maxConnect).arg(nAttempt);
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt, false);
+	}
+	EndSnapshot (pdb, snapshot);
+
+	int ThrWorks = timeSql.msecsTo(QDateTime::currentDateTime());
+	if (m_tabcol->bExplain == true && pThr[0].CodeErr == 0) {	// the count & the first part (the other parts: the same shape)
+		explain exC, exR;
+		if (ExplainRun(pdb, SqlDrv, m_tabcol, cnttest, exC) == true)
+			ExplainLog (m_tabcol, exC, msCnt, cnt_rows);
+		if (ExplainRun(pThr[0].pDb, SqlDrv, m_tabcol, pThr[0].tsql, exR) == true)
+			ExplainLog (m_tabcol, exR, (pThr[0].ms >= 0) ? pThr[0].ms : ThrWorks, pThr[0].m_lines.m_tabdata.size());
+	}
+	if (ThrWorks < 1000)	sprintf(txtTime, "%d msec", ThrWorks);
+	else					sprintf(txtTime, "%.2f sec", ThrWorks / 1000.);
+
+	int unsupp	= -1;
+	int CodErr  = 0;
+	QString Err = "", ErrSql = "";
+	for (int nn = 0; nn < maxConnect; nn++) {	
+		// if one of the threads did not fulfill the database request - stop!
+		if (pThr[nn].CodeErr != 0) {
+			CodErr  = pThr[nn].CodeErr;
+			Err		= pThr[nn].DbErr;
+			ErrSql	= pThr[nn].tsql;
+			break;
+		}
+
+		if (pThr[0].m_lines.b_Unsuppt == true && nn == 0) 
+			unsupp = pThr[0].m_lines.ColUnsupp;
+			
+		// save data from all threads to the output-list
+		m_lines->m_crcline.append(pThr[nn].m_lines.m_crcline);
+		m_lines->m_tabdata.append(pThr[nn].m_lines.m_tabdata);
+		m_lines->m_keyline.append(pThr[nn].m_lines.m_keyline);
+		if (m_lines->m_typeCol.size() == 0) {
+			m_lines->m_typeCol.append(pThr[nn].m_lines.m_typeCol);
+			m_lines->m_nameCol.append(pThr[nn].m_lines.m_nameCol);
+			m_lines->m_codec   = pThr[nn].m_lines.m_codec;
+			m_lines->m_keyKind = pThr[nn].m_lines.m_keyKind;
+		}
+		// free
+		pThr[nn].m_lines.m_crcline.clear();
+		pThr[nn].m_lines.m_keyline.clear();
+		pThr[nn].m_lines.m_tabdata.clear();
+		pThr[nn].m_lines.m_typeCol.clear();
+		pThr[nn].m_lines.m_nameCol.clear();
+	}
+
+	if (CodErr != 0) {
+		printf ("SQL execution error: %s\n", qPrintable(Err));
+		AddLog(m_tabcol, "Err: " + Err, false);
+		AddLog(m_tabcol, "SQL: " + ErrSql, false);
+		AddLog(m_tabcol, " ");
+		return -1;
+	}
+
+ 	printf ("Read  data: finish (%s)\n\n", txtTime);
+	
+	if (m_lines->m_tabdata.size() != cnt_rows)
+		printf ("  Warning ! Received rows %d of %d\n", m_lines->m_tabdata.size(), cnt_rows);
+	if (unsupp > 0) {
+		QString errCol = QString ("  Warning ! Column type unsupported (%1)\n").arg(unsupp);
+		printf ("%s", qPrintable(errCol));
+		AddLog(m_tabcol, errCol, false);
+	}
+	printf ("\n");
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// continue the changes of the journal w/o reading the tables
+int TableResume(QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol)
+{
+	printf ("\n------------------------------------------------------------------\n");
+
+	journal jr;
+	jr.path  = m_tabcol->pathJrn;
+	jr.ident = m_tabcol->identJrn;
+	int err  = JournalLoad (&jr);
+	if (err != 0) {
+		QString tt = (err == -50) ? "Journal isn't found: " + jr.path : "Journal doesn't match the TableFile and the databases: " + jr.path;
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt, false);
+		JournalClose (&jr, false);
+		return err;
+	}
+
+	// destination table is the same (columns type)
+	QSqlRecord rec;
+	if (GetColProbe(pdb, m_tabcol, rec) != 0) {
+		JournalClose (&jr, false);
+		return -41;
+	}
+	linetab probe;
+	GetColTypes (rec, &probe);
+	if (probe.m_typeCol != jr.typeD.mid(0, probe.m_typeCol.size()) || probe.m_typeCol.size() + 1 != jr.typeD.size()) {
+		QString tt = "Journal doesn't match the columns of the destination table.";
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt, false);
+		JournalClose (&jr, false);
+		return -52;
+	}
+
+	int nDone = 0;
+	for (int k = 0; k < jr.state.size(); k++)
+		if (jr.state.at(k) != 0) nDone++;
+	printf ("Journal: %d rows, processed %d\n", jr.acts.size(), nDone);
+
+	AddLog(m_tabcol, "Table: " + m_tabcol->tab + " (resume)", false);
+	QString txt = "Columns: "; for (int b=0; b < m_tabcol->col.size(); b++)	txt += m_tabcol->col.at(b) + ";"; AddLog(m_tabcol, txt, false);
+
+	linetab headS, headD;
+	headS.m_typeCol = jr.typeS;	headS.m_codec = GetRowCodec(jr.typeS);
+	headD.m_typeCol = jr.typeD;	headD.m_codec = GetRowCodec(jr.typeD);
+
+	m_tabcol->bKeyGuard = true;		// the rows can be changed after the journal
+	err = ApplyActions (pdb, SqlDrv, m_tabcol, &headS, &headD, &jr);
+
+	JournalClose (&jr, err == 0);
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+// statistical sampling: the differences are estimated on a random part of the rows, w/o changes
+#define SAMPLE_KEYS	100			// keys in one query of the other side
+
+int GetSampleSql (QString SqlDrv, tabcol* m_tabcol, double percent, QString& sql)	// rows of the table (percent: random rows)
+{
+	QString cols = "";
+	for (int i = 0; i < m_tabcol->col.size(); i++)
+		cols += m_tabcol->col.at(i).trimmed() + ",";
+
+	QString pc = QString::number(percent, 'f', 6);
+	if (SqlDrv == "QOCI") {
+		sql = "select " + cols + "t.rowid DbSyncExtentKeyId from " + m_tabcol->tab;
+		if (percent > 0)	sql += " sample(" + pc + ")";
+		sql += " t";
+	} else
+	if (SqlDrv == "QPSQL") {
+		sql = "select " + cols + "ctid as DbSyncExtentKeyId from " + m_tabcol->tab + " t";
+		if (percent > 0)	sql += " tablesample bernoulli(" + pc + ")";
+	} else {
+		printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
+		return -30;	// w/o rowid !!!
+	}
+
+	if (m_tabcol->where.isEmpty() == false)
+		sql += " where (" + m_tabcol->where + ")";
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+int GetSampleRows (QSqlDatabase* pdb, QString SqlDrv, QSql::NumericalPrecisionPolicy numPolicy, QString sql, tabcol* m_tabcol, linetab* m_lines, int posCrc=-1)	// rows of the query (one connection)
+{
+	// for debug
+	if (m_tabcol->bDebug == true) AddLog(m_tabcol, "  " + sql, false);
+
+	CMyDbThread thr;
+	thr.tsql		= sql;
+	thr.pDb			= pdb;
+	thr.SqlDrv		= SqlDrv;
+	thr.numPolicy	= numPolicy;
+	thr.poskey		= m_tabcol->poskey;
+	thr.posCrc		= posCrc;
+	thr.Instance	= 0;
+	thr.start();
+	thr.wait();
+
+	if (thr.CodeErr != 0) {
+		printf ("SQL execution error: %s\n", qPrintable(thr.DbErr));
+		AddLog(m_tabcol, "Err: " + thr.DbErr, false);
+		AddLog(m_tabcol, "SQL: " + sql, false);
+		AddLog(m_tabcol, " ");
+		return -1;
+	}
+
+	m_lines->m_crcline.append(thr.m_lines.m_crcline);
+	m_lines->m_tabdata.append(thr.m_lines.m_tabdata);
+	m_lines->m_keyline.append(thr.m_lines.m_keyline);
+	if (m_lines->m_typeCol.size() == 0) {
+		m_lines->m_typeCol = thr.m_lines.m_typeCol;
+		m_lines->m_nameCol = thr.m_lines.m_nameCol;
+		m_lines->m_codec   = thr.m_lines.m_codec;
+		m_lines->m_keyKind = thr.m_lines.m_keyKind;
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+int GetSampleKeys (QSqlDatabase* pdb, QString SqlDrv, QSql::NumericalPrecisionPolicy numPolicy, tabcol* m_tabcol, linetab* m_sample, linetab* m_lines)	// rows of the other side with the keys of the sample
+{
+	QString sql0;
+	if (GetSampleSql(SqlDrv, m_tabcol, 0, sql0) != 0)
+		return -30;
+	sql0 += (m_tabcol->where.isEmpty() == true) ? " where (" : " and (";
+
+	for (int k = 0; k < m_sample->m_tabdata.size(); k += SAMPLE_KEYS) {
+		QString sql = sql0;
+		for (int i = k; i < m_sample->m_tabdata.size() && i < k + SAMPLE_KEYS; i++) {
+			QString kw = GetKeyWhere(m_tabcol, m_sample, m_sample->m_tabdata.at(i));
+			if (kw.isEmpty() == true) {		// the whole table would be read
+				printf ("Key lookup needs key columns (w/o blob).\n");
+				return -31;
+			}
+			if (i > k)	sql += " or ";
+			sql += "(1=1" + kw + ")";
+		}
+		sql += ")";
+
+		if (GetSampleRows(pdb, SqlDrv, numPolicy, sql, m_tabcol, m_lines) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// verification after the changes: the rows of the changed keys and a sample of the other rows are
+// read again from the destination and compared with the source rows of the run (residual differences)
+#define VERIFY_MAX		100000		// rows of the sample (max)
+
+void VerifyApplied (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, linetab* headS, linetab* headD, const QList<rowact>& acts, const linetab& smp)
+{
+	QElapsedTimer timer;
+	timer.start();
+	CTraceSpan tr("verify", m_tabcol->tab, acts.size() + smp.m_tabdata.size());
+
+	// expected rows (source) & the keys of the deleted rows (destination)
+	linetab expS = GetHead(headS), keysD = GetHead(headD);
+	CRowHasher hasher;
+	int nChanged = 0;
+	for (int k = 0; k < acts.size(); k++) {
+		const rowact& act = acts.at(k);
+		if ((act.mode == 0 && m_tabcol->bIgnDel == true) || (act.mode == 1 && m_tabcol->bIgnIns == true) || (act.mode == 2 && m_tabcol->bIgnUpd == true))
+			continue;	// isn't changed
+		nChanged++;
+		if (act.mode == 0) {
+			keysD.m_tabdata.append(act.rowD);
+			continue;
+		}
+		expS.m_tabdata.append(act.rowS);
+		hasher.Add (act.rowS, headS->m_codec, &expS.m_crcline);
+	}
+	hasher.Flush (&expS.m_crcline);
+	QSet<QString> crcChanged;
+	for (int i = 0; i < expS.m_crcline.size(); i++)
+		crcChanged.insert(expS.m_crcline.at(i));
+	for (int i = 0; i < smp.m_tabdata.size(); i++) {
+		if (crcChanged.contains(smp.m_crcline.at(i)) == true)	// the row is changed: once
+			continue;
+		expS.m_tabdata.append(smp.m_tabdata.at(i));
+		expS.m_crcline.append(smp.m_crcline.at(i));
+	}
+
+	QSqlRecord recProbe;
+	linetab linesD;
+	int err = GetColProbe(pdb, m_tabcol, recProbe);
+	if (err == 0)	err = GetSampleKeys(pdb, SqlDrv, GetNumPolicy(recProbe), m_tabcol, &expS,  &linesD);
+	if (err == 0)	err = GetSampleKeys(pdb, SqlDrv, GetNumPolicy(recProbe), m_tabcol, &keysD, &linesD);
+	if (err != 0) {
+		QString tt = QString("Warning ! Verification isn't done (%1).").arg(err);
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt);
+		return;
+	}
+	if (linesD.m_typeCol.size() == 0)
+		linesD = GetHead(headD);
+
+	QList<rowact> rest;
+	int nIdent = GetRowActs (m_tabcol, &expS, &linesD, rest);
+	int nDiff = 0, nUnnec = 0, nMiss = 0;
+	for (int k = 0; k < rest.size(); k++) {
+		if      (rest.at(k).mode == 2)	nDiff++;
+		else if (rest.at(k).mode == 0)	nUnnec++;
+		else							nMiss++;
+	}
+
+	QStringList tot;
+	tot << QString("Verification: %1 changed rows, %2 rows of the sample (%3 sec)").arg(nChanged).arg(smp.m_tabdata.size()).arg(timer.elapsed() / 1000., 0, 'f', 2);
+	tot << QString("   Identical   rows (Src==Dst): %1").arg(nIdent);
+	tot << QString("   Residual differences: %1 (different %2, unnecessary %3, missing %4)").arg(rest.size()).arg(nDiff).arg(nUnnec).arg(nMiss);
+	AddLog(m_tabcol, QString("-----------------------------------------"));
+	printf ("\n");
+	for (int k = 0; k < tot.size(); k++) {
+		AddLog(m_tabcol, tot.at(k));
+		printf ("%s\n", qPrintable(tot.at(k)));
+	}
+	for (int k = 0; k < rest.size(); k++) {		// the keys of the rows (log)
+		bool bD = (rest.at(k).mode == 0);
+		AddLog(m_tabcol, "   Residual row:" + GetKeyWhere(m_tabcol, bD ? &linesD : &expS, bD ? rest.at(k).rowD : rest.at(k).rowS).mid(4));
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+int TableComparison(QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, linetab* m_linesS, linetab* m_linesD, int nIdent = 0)	// nIdent: identical rows w/o reading
+{
+	printf ("\n------------------------------------------------------------------\n");
+
+	// for debug
+	if (m_tabcol->bDebug == true)  AddLog(m_tabcol, "\n", false);
+
+	AddLog(m_tabcol, "Table: " + m_tabcol->tab, false);
+	QString txt = "Columns: "; for (int b=0; b < m_tabcol->col.size(); b++)	txt += m_tabcol->col.at(b) + ";"; AddLog(m_tabcol, txt, false);
+
+	journal jr;
+	jr.path		= m_tabcol->pathJrn;
+	jr.ident	= m_tabcol->identJrn;
+	jr.typeS	= m_linesS->m_typeCol;
+	jr.typeD	= m_linesD->m_typeCol;
+
+	// the rows of the source for the verification (w/o changes): evenly over the table
+	linetab smp = GetHead(m_linesS);
+	int nS = m_linesS->m_tabdata.size();
+	for (int i = 0; m_tabcol->verify > 0 && i < nS; i += qMax(1, nS / m_tabcol->verify)) {
+		smp.m_tabdata.append(m_linesS->m_tabdata.at(i));
+		smp.m_crcline.append(m_linesS->m_crcline.at(i));
+	}
+	jr.Identical= GetRowActs (m_tabcol, m_linesS, m_linesD, jr.acts) + nIdent;
+
+	// the changes are saved before the first of them
+	if (IsRecovery(m_tabcol) == true && jr.acts.size() > 0 && jr.path.isEmpty() == false)
+		JournalCreate (&jr);
+
+	linetab headS = GetHead(m_linesS), headD = GetHead(m_linesD);
+	int err = ApplyActions (pdb, SqlDrv, m_tabcol, &headS, &headD, &jr);
+
+	JournalClose (&jr, err == 0);
+	if (m_tabcol->verify >= 0 && IsRecovery(m_tabcol) == true)
+		VerifyApplied (pdb, SqlDrv, m_tabcol, &headS, &headD, jr.acts, smp);
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+QString SampleEstimate (int cnt, int n, qint64 total)	// rows of the table by the sample, error bar (95%)
+{
+	if (n <= 0)
+		return "-";
+
+	double fpc = (total > n) ? qSqrt((double)(total - n) / (total - 1)) : 0;	// finite population
+	if (cnt == 0)	// rule of three
+		return QString("0 (< %1)").arg(qRound64(qMin(1., 3. / n) * total * fpc));
+
+	double p   = (double)cnt / n;
+	double err = 1.96 * qSqrt(p * (1 - p) / n) * fpc;
+	return QString("%1 +- %2").arg(qRound64(p * total)).arg(qRound64(err * total));
+}
+
+//-------------------------------------------------------------------------------------------------
+int TableSample(QSqlDatabase* pdbS, QString SqlDrvS, QSqlDatabase* pdbD, QString SqlDrvD, tabcol* m_tabcol)
+{
+	printf ("\n------------------------------------------------------------------\n");
+
+	// for debug
+	if (m_tabcol->bDebug == true)  AddLog(m_tabcol, "\n", false);
+
+	AddLog(m_tabcol, QString("Table: %1 (sample %2%)").arg(m_tabcol->tab).arg(m_tabcol->sample), false);
+	QString txt = "Columns: "; for (int b=0; b < m_tabcol->col.size(); b++)	txt += m_tabcol->col.at(b) + ";"; AddLog(m_tabcol, txt, false);
+
+	QElapsedTimer timer;
+	timer.start();
+
+	// get rows count
+	qint64 cnt[2] = { 0, 0 };
+	QSql::NumericalPrecisionPolicy numPolicy[2];
+	QSqlDatabase* pdb[2] = { pdbS, pdbD };
+	for (int s = 0; s < 2; s++) {
+		QString cnttest = "select count(*) from " + m_tabcol->tab;
+		if (m_tabcol->where.isEmpty() == false)
+			cnttest += " where " + m_tabcol->where;
+
+		QSqlQuery query0(*pdb[s]);
+		if (query0.exec(cnttest) == false)
+			return SaveErr (&query0, cnttest, m_tabcol, -33);
+		if (query0.next())
+			cnt[s] = query0.value(0).toLongLong();
+
+		QSqlRecord recProbe;
+		if (GetColProbe(pdb[s], m_tabcol, recProbe) != 0)
+			return -41;
+		numPolicy[s] = GetNumPolicy(recProbe);
+	}
+	printf ("Rows count: %lld (Src), %lld (Dst)\n", cnt[0], cnt[1]);
+
+	QString sqlS, sqlD;
+	if (GetSampleSql(SqlDrvS, m_tabcol, m_tabcol->sample, sqlS) != 0 ||
+		GetSampleSql(SqlDrvD, m_tabcol, m_tabcol->sample, sqlD) != 0)
+		return -30;
+
+	printf ("Read  sample: start\n");
+
+	// source sample & destination rows with the same keys: different, missing rows
+	linetab smpS, keyD;
+	if (GetSampleRows(pdbS, SqlDrvS, numPolicy[0], sqlS, m_tabcol, &smpS) != 0)					return -11;
+	if (GetSampleKeys(pdbD, SqlDrvD, numPolicy[1], m_tabcol, &smpS, &keyD) != 0)		return -13;
+
+	// destination sample & source rows with the same keys: unnecessary rows
+	linetab smpD, keyS;
+	if (GetSampleRows(pdbD, SqlDrvD, numPolicy[1], sqlD, m_tabcol, &smpD) != 0)					return -13;
+	if (GetSampleKeys(pdbS, SqlDrvS, numPolicy[0], m_tabcol, &smpD, &keyS) != 0)		return -11;
+
+	printf ("Read  sample: finish (%.2f sec)\n\n", timer.elapsed() / 1000.);
+
+	int nS = smpS.m_tabdata.size(), nD = smpD.m_tabdata.size();
+	QList<rowact> actS, actD;
+	int DuplicateRows = GetRowActs (m_tabcol, &smpS, &keyD, actS);
+	GetRowActs (m_tabcol, &keyS, &smpD, actD);
+
+	int DifferentRows = 0, UnnecessRows = 0, MissingRows = 0;
+	for (int k = 0; k < actS.size(); k++) {
+		if		(actS.at(k).mode == 2)	DifferentRows++;
+		else if (actS.at(k).mode == 1)	MissingRows++;
+	}
+	for (int k = 0; k < actD.size(); k++)
+		if (actD.at(k).mode == 0)		UnnecessRows++;
+
+	QStringList tot;
+	tot << QString("Sample %1% of the rows: %2 (Src), %3 (Dst), %4 sec").arg(m_tabcol->sample).arg(nS).arg(nD).arg(timer.elapsed() / 1000., 0, 'f', 2);
+	tot << QString("Estimated differences (sample rows / table rows, 95% error bar):");
+	tot << QString("   Identical   rows (Src==Dst): %1 / %2").arg(DuplicateRows).arg(SampleEstimate(DuplicateRows, nS, cnt[0]));
+	tot << QString("   Different   rows (Src<>Dst): %1 / %2").arg(DifferentRows).arg(SampleEstimate(DifferentRows, nS, cnt[0]));
+	tot << QString("   Unnecessary rows (Only Dst): %1 / %2").arg(UnnecessRows ).arg(SampleEstimate(UnnecessRows,  nD, cnt[1]));
+	tot << QString("   Missing     rows (Only Src): %1 / %2").arg(MissingRows  ).arg(SampleEstimate(MissingRows,   nS, cnt[0]));
+
+	AddLog(m_tabcol, QString("-----------------------------------------"));
+	printf ("\n------------------------------------------------------------------\n");
+	for (int k = 0; k < tot.size(); k++) {
+		AddLog(m_tabcol, tot.at(k));
+		printf ("%s\n", qPrintable(tot.at(k)));
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// QOCI: the columns of the row hash are text by the session formats (date w/o time by default).
+// full date & time, fractions of seconds and the decimal point for the hash of the row
+int SetHashNls (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol)
+{
+	if (SqlDrv != "QOCI")
+		return 0;
+	QString sql = "alter session set nls_date_format='YYYY-MM-DD HH24:MI:SS' nls_timestamp_format='YYYY-MM-DD HH24:MI:SS.FF9' "
+				  "nls_timestamp_tz_format='YYYY-MM-DD HH24:MI:SS.FF9 TZH:TZM' nls_numeric_characters='.,'";
+	QSqlQuery query(*pdb);
+	if (query.exec(sql) == false)
+		return SaveErr (&query, sql, m_tabcol, -34);
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// comparison on the destination server: the source table is reachable from the destination Db
+// (same cluster, postgres_fdw, dblink view, Oracle db link). FULL OUTER JOIN by the key with the
+// checksum of the row returns the keys of the different rows only, then these rows are read by the key
+int GetJoinSql (QString SqlDrv, tabcol* m_tabcol, QString& sql)	// keys of the different rows
+{
+	QString cols = "", hash = "", keys = "", sel = "";
+	for (int i = 0; i < m_tabcol->col.size(); i++) {
+		QString c = m_tabcol->col.at(i).trimmed();
+		cols += c + ",";
+		if (SqlDrv == "QPSQL")	hash += ((i > 0) ? "," : "") + c;
+		else					hash += c + "||'|'||";
+		if (m_tabcol->poskey.contains(i) == true) {
+			keys += ((keys.isEmpty() == true) ? "" : " and ") + QString("s.%1=d.%1").arg(c);
+			sel  += QString("coalesce(s.%1,d.%1) %1,").arg(c);
+		}
+		else {
+			sel  += "null " + c + ",";
+		}
+	}
+	if (keys.isEmpty() == true) {
+		printf ("Comparison on the server needs key columns.\n");
+		return -31;
+	}
+
+	if (SqlDrv == "QPSQL")	hash = "md5(row(" + hash + ")::text) DbSyncRowHash";
+	else
+	if (SqlDrv == "QOCI")	hash = "standard_hash(" + hash.left(hash.size() - 7) + ", 'MD5') DbSyncRowHash";
+	else {
+		printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
+		return -30;
+	}
+
+	QString where = (m_tabcol->where.isEmpty() == true) ? "" : " where (" + m_tabcol->where + ")";
+	sql = "select " + sel + "null DbSyncExtentKeyId from " +
+		  "(select " + cols + hash + " from " + m_tabcol->joinSrc + where + ") s full outer join " +
+		  "(select " + cols + hash + " from " + m_tabcol->tab     + where + ") d on (" + keys + ")" +
+		  " where s.DbSyncRowHash is null or d.DbSyncRowHash is null or s.DbSyncRowHash<>d.DbSyncRowHash";
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+int TableServerJoin(QSqlDatabase* pdbS, QString SqlDrvS, QSqlDatabase* pdbD, QString SqlDrvD, tabcol* m_tabcol)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	// rows of the source: identical rows aren't read
+	QString cnttest = "select count(*) from " + m_tabcol->tab;
+	if (m_tabcol->where.isEmpty() == false)
+		cnttest += " where " + m_tabcol->where;
+	QSqlQuery query0(*pdbS);
+	if (query0.exec(cnttest) == false)
+		return SaveErr (&query0, cnttest, m_tabcol, -33);
+	qint64 cntS = (query0.next() == true) ? query0.value(0).toLongLong() : 0;
+	printf ("Rows count: %lld (Src)\n", cntS);
+
+	QSql::NumericalPrecisionPolicy numPolicy[2];
+	QSqlDatabase* pdb[2] = { pdbS, pdbD };
+	for (int s = 0; s < 2; s++) {
+		QSqlRecord recProbe;
+		if (GetColProbe(pdb[s], m_tabcol, recProbe) != 0)
+			return -41;
+		numPolicy[s] = GetNumPolicy(recProbe);
+	}
+
+	QString sql;
+	if (GetJoinSql(SqlDrvD, m_tabcol, sql) != 0)
+		return -30;
+	if (SetHashNls(pdbD, SqlDrvD, m_tabcol) != 0)
+		return -13;
+
+	printf ("Join  data: start (%s)\n", qPrintable(m_tabcol->joinSrc));
+	linetab keys, linesS, linesD;
+	{
+		CTraceSpan tr("server join", m_tabcol->joinSrc);
+		if (GetSampleRows(pdbD, SqlDrvD, numPolicy[1], sql, m_tabcol, &keys) != 0)	return -13;
+		tr.n = keys.m_tabdata.size();
+	}
+	printf ("Join  data: finish (%.2f sec), %d keys of different rows\n", timer.elapsed() / 1000., keys.m_tabdata.size());
+
+	// the rows of the keys (the columns & rowid as GetDataTable)
+	if (GetSampleKeys(pdbS, SqlDrvS, numPolicy[0], m_tabcol, &keys, &linesS) != 0)		return -11;
+	if (GetSampleKeys(pdbD, SqlDrvD, numPolicy[1], m_tabcol, &keys, &linesD) != 0)		return -13;
+	if (keys.m_tabdata.size() == 0) {	// columns of the tables for the log & journal
+		QString sqlS, sqlD;
+		if (GetSampleSql(SqlDrvS, m_tabcol, 0, sqlS) != 0 || GetSampleSql(SqlDrvD, m_tabcol, 0, sqlD) != 0)
+			return -30;
+		if (GetSampleRows(pdbS, SqlDrvS, numPolicy[0], "select * from (" + sqlS + ") t where 1=0", m_tabcol, &linesS) != 0)	return -11;
+		if (GetSampleRows(pdbD, SqlDrvD, numPolicy[1], "select * from (" + sqlD + ") t where 1=0", m_tabcol, &linesD) != 0)	return -13;
+	}
+	printf ("Read  data: finish (%.2f sec)\n", timer.elapsed() / 1000.);
+
+	int nIdent = (int)(cntS - linesS.m_tabdata.size());
+	return TableComparison(pdbD, SqlDrvD, m_tabcol, &linesS, &linesD, qMax(0, nIdent));
+}
+
+//-------------------------------------------------------------------------------------------------
+int GetKeyHead (QSqlDatabase* pdb, QString SqlDrv, QSql::NumericalPrecisionPolicy numPolicy, tabcol* m_tabcol, linetab* keys)	// columns of the table (w/o rows)
+{
+	QString sql;
+	if (GetSampleSql(SqlDrv, m_tabcol, 0, sql) != 0)
+		return -30;
+	return GetSampleRows(pdb, SqlDrv, numPolicy, "select * from (" + sql + ") t where 1=0", m_tabcol, keys);
+}
+
+//-------------------------------------------------------------------------------------------------
+void AddKeyRow (tabcol* m_tabcol, linetab* keys, const QVariantList& vk)	// key values (poskey order) in the columns of the table, the other columns are null
+{
+	QVariantList row;
+	for (int i = 0; i < keys->m_typeCol.size(); i++)
+		row.append(QVariant());
+	for (int n = 0; n < m_tabcol->poskey.size() && n < vk.size(); n++) {
+		int indx = m_tabcol->poskey.at(n);
+		QVariant v = vk.at(n);
+		if (v.isNull() == false && (int)v.type() != keys->m_typeCol.at(indx))
+			v.convert(keys->m_typeCol.at(indx));
+		row[indx] = v;
+	}
+	keys->m_tabdata.append(row);
+}
+
+//-------------------------------------------------------------------------------------------------
+// the rows of the keys on both sides (the columns & rowid as GetDataTable), then the comparison
+int TableKeys(QSqlDatabase* pdbS, QString SqlDrvS, QSqlDatabase* pdbD, QString SqlDrvD, QSql::NumericalPrecisionPolicy* numPolicy, tabcol* m_tabcol, linetab* keys, int nIdent, QElapsedTimer* timer)
+{
+	linetab linesS, linesD;
+	if (GetSampleKeys(pdbS, SqlDrvS, numPolicy[0], m_tabcol, keys, &linesS) != 0)		return -11;
+	if (GetSampleKeys(pdbD, SqlDrvD, numPolicy[1], m_tabcol, keys, &linesD) != 0)		return -13;
+	if (keys->m_tabdata.size() == 0) {	// columns of the tables for the log & journal
+		linesS = GetHead(keys);
+		if (GetKeyHead(pdbD, SqlDrvD, numPolicy[1], m_tabcol, &linesD) != 0)			return -13;
+	}
+	printf ("Read  data: finish (%.2f sec)\n", timer->elapsed() / 1000.);
+
+	return TableComparison(pdbD, SqlDrvD, m_tabcol, &linesS, &linesD, nIdent);
+}
+
+//-------------------------------------------------------------------------------------------------
+// stored checksum of the row (TableFile: line 6). The key & checksum columns are read on both sides
+// (index only scan by the index on key, checksum), the stored values are compared as the checksums
+// of the rows (w/o hashing on the client), then only the rows of the different keys are read
+int GetHashSql (QString SqlDrv, tabcol* m_tabcol, QString& sql)	// key & stored checksum
+{
+	QString keys = "";
+	for (int n = 0; n < m_tabcol->poskey.size(); n++)
+		keys += ((n > 0) ? "," : "") + m_tabcol->col.at(m_tabcol->poskey.at(n)).trimmed();
+	if (keys.isEmpty() == true) {
+		printf ("Stored checksum needs key columns.\n");
+		return -31;
+	}
+	if (SqlDrv != "QOCI" && SqlDrv != "QPSQL") {
+		printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
+		return -30;
+	}
+
+	sql = "select " + keys + "," + m_tabcol->hashCol.trimmed() + ",null DbSyncExtentKeyId from " + m_tabcol->tab;
+	if (m_tabcol->where.isEmpty() == false)
+		sql += " where (" + m_tabcol->where + ")";
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+int TableStoredHash(QSqlDatabase* pdbS, QString SqlDrvS, QSqlDatabase* pdbD, QString SqlDrvD, tabcol* m_tabcol)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	QSql::NumericalPrecisionPolicy numPolicy[2];
+	QSqlDatabase* pdb[2] = { pdbS, pdbD };
+	for (int s = 0; s < 2; s++) {
+		QSqlRecord recProbe;
+		if (GetColProbe(pdb[s], m_tabcol, recProbe) != 0)
+			return -41;
+		numPolicy[s] = GetNumPolicy(recProbe);
+	}
+
+	// key & checksum: the key columns are the first ones
+	tabcol th = *m_tabcol;
+	th.logData = "";
+	th.col.clear();
+	th.poskey.clear();
+	for (int n = 0; n < m_tabcol->poskey.size(); n++) {
+		th.col.append(m_tabcol->col.at(m_tabcol->poskey.at(n)));
+		th.poskey.append(n);
+	}
+	th.col.append(m_tabcol->hashCol);
+
+	QString sqlS, sqlD;
+	if (GetHashSql(SqlDrvS, m_tabcol, sqlS) != 0 || GetHashSql(SqlDrvD, m_tabcol, sqlD) != 0)
+		return -30;
+
+	printf ("Read  checksums: start (%s)\n", qPrintable(m_tabcol->hashCol));
+	linetab hashS, hashD;
+	{
+		CTraceSpan tr("stored hash", m_tabcol->hashCol);
+		int posCrc = th.poskey.size();	// after the keys
+		int errS = GetSampleRows(pdbS, SqlDrvS, numPolicy[0], sqlS, &th, &hashS, posCrc);
+		int errD = (errS == 0) ? GetSampleRows(pdbD, SqlDrvD, numPolicy[1], sqlD, &th, &hashD, posCrc) : 0;
+		m_tabcol->logData += th.logData;
+		if (errS != 0)	return -11;
+		if (errD != 0)	return -13;
+		tr.n = hashS.m_tabdata.size() + hashD.m_tabdata.size();
+	}
+	int cntS = hashS.m_tabdata.size();
+	QList<rowact> acts;
+	int nIdent = GetRowActs (&th, &hashS, &hashD, acts);
+	printf ("Read  checksums: finish (%.2f sec), %d rows (Src), %d keys of different rows\n", timer.elapsed() / 1000., cntS, acts.size());
+
+	// the keys in the columns of the table
+	linetab keys;
+	if (GetKeyHead(pdbS, SqlDrvS, numPolicy[0], m_tabcol, &keys) != 0)
+		return -11;
+	for (int k = 0; k < acts.size(); k++)
+		AddKeyRow (m_tabcol, &keys, (acts.at(k).mode == 0) ? acts.at(k).rowD : acts.at(k).rowS);
+
+	// the rows of the different checksums are compared by all columns (an old checksum: identical rows)
+	return TableKeys(pdbS, SqlDrvS, pdbD, SqlDrvD, numPolicy, m_tabcol, &keys, nIdent, &timer);
+}
+
+//-------------------------------------------------------------------------------------------------
+// changed keys only: the logical replication slot of the source (test_decoding) gives the keys of
+// the rows changed since the last check, only these rows are compared. The slot is moved on after
+// the successful synchronization (w/o -x: the changes are read again next time). The slot must be
+// used by one table only: with the changes of other tables it isn't moved
+#define CHANGES_MAX		100000		// changes of the slot at once (whole transactions), the rest - next time
+
+inline bool IsSlotTable (const QString& name, const QString& tab)	// table of the change (schema.table)
+{
+	QString a = QString(name).remove('"').toLower(), b = QString(tab).remove('"').toLower().trimmed();
+	if (b.contains('.') == false)
+		a = a.mid(a.lastIndexOf('.') + 1);
+	return a == b;
+}
+
+//-------------------------------------------------------------------------------------------------
+// columns of the change: "table public.t: UPDATE: [old-key:] id[integer]:1 name[text]:'a''b' [new-tuple: ...]"
+// the values of the key columns (old key & new key)
+void GetSlotKeys (const QString& data, tabcol* m_tabcol, QList<QVariantList>& vkeys)
+{
+	int pos = data.indexOf(": ");			// after the table
+	pos = data.indexOf(": ", pos + 2);		// after the action
+	if (pos < 0)
+		return;
+	pos += 2;
+
+	QVariantList vk;
+	for (int n = 0; n < m_tabcol->poskey.size(); n++)	vk.append(QVariant());
+	int found = 0;
+	while (pos < data.size()) {
+		while (pos < data.size() && data.at(pos) == ' ')	pos++;
+		if (data.mid(pos, 8) == "old-key:" || data.mid(pos, 10) == "new-tuple:") {	// next row of the change
+			if (found > 0)	vkeys.append(vk);
+			found = 0;
+			pos = data.indexOf(':', pos) + 1;
+			continue;
+		}
+		int br  = data.indexOf('[', pos);
+		int end = data.indexOf("]:", br);
+		if (br < 0 || end < 0)
+			break;
+		QString col = data.mid(pos, br - pos).remove('"');
+		pos = end + 2;
+
+		QString val;
+		bool bNull = false;
+		if (pos < data.size() && data.at(pos) == '\'') {	// quoted: '' inside
+			for (pos++; pos < data.size(); pos++) {
+				if (data.at(pos) == '\'') {
+					if (pos + 1 < data.size() && data.at(pos + 1) == '\'')	pos++;
+					else													{ pos++; break; }
+				}
+				val += data.at(pos);
+			}
+		}
+		else {
+			int sp = data.indexOf(' ', pos);
+			if (sp < 0)	sp = data.size();
+			val   = data.mid(pos, sp - pos);
+			bNull = (val == "null");
+			pos   = sp;
+		}
+		for (int n = 0; n < m_tabcol->poskey.size(); n++) {
+			if (col.compare(m_tabcol->col.at(m_tabcol->poskey.at(n)).trimmed().remove('"'), Qt::CaseInsensitive) != 0)
+				continue;
+			vk[n] = (bNull == true) ? QVariant() : QVariant(val);
+			found++;
+		}
+	}
+	if (found > 0)
+		vkeys.append(vk);
+}
+
+//-------------------------------------------------------------------------------------------------
+int TableChanges(QSqlDatabase* pdbS, QString SqlDrvS, QSqlDatabase* pdbD, QString SqlDrvD, tabcol* m_tabcol)
+{
+	if (SqlDrvS != "QPSQL") {
+		printf ("Changed keys: the source must be PostgreSQL (logical replication slot).\n");
+		return -30;
+	}
+	if (m_tabcol->poskey.size() == 0) {
+		printf ("Changed keys need key columns.\n");
+		return -31;
+	}
+	QElapsedTimer timer;
+	timer.start();
+
+	QSql::NumericalPrecisionPolicy numPolicy[2];
+	QSqlDatabase* pdb[2] = { pdbS, pdbD };
+	for (int s = 0; s < 2; s++) {
+		QSqlRecord recProbe;
+		if (GetColProbe(pdb[s], m_tabcol, recProbe) != 0)
+			return -41;
+		numPolicy[s] = GetNumPolicy(recProbe);
+	}
+
+	// the changes since the last check (the slot isn't moved yet)
+	QString sql = QString("select lsn::text, data from pg_logical_slot_peek_changes('%1', null, %2, 'include-xids', '0', 'skip-empty-xacts', '1')")
+				  .arg(QString(m_tabcol->slot).replace("'", "''")).arg(CHANGES_MAX);
+	if (m_tabcol->bDebug == true) AddLog(m_tabcol, "  " + sql, false);
+
+	printf ("Read  changes: start (slot %s)\n", qPrintable(m_tabcol->slot));
+	linetab keys;
+	if (GetKeyHead(pdbS, SqlDrvS, numPolicy[0], m_tabcol, &keys) != 0)
+		return -11;
+
+	QString lsn = "";
+	int nChange = 0, nOther = 0;
+	{
+		CTraceSpan tr("slot changes", m_tabcol->slot);
+		QSqlQuery query(*pdbS);
+		query.setForwardOnly(true);
+		if (query.exec(sql) == false)
+			return SaveErr (&query, sql, m_tabcol, -34);
+
+		QSet<QString> seen;
+		while (query.next()) {
+			lsn = query.value(0).toString();
+			QString data = query.value(1).toString();
+			if (data.startsWith("table ") == false)		// begin, commit
+				continue;
+			if (IsSlotTable(data.mid(6, data.indexOf(": ") - 6), m_tabcol->tab) == false) {
+				nOther++;
+				continue;
+			}
+			nChange++;
+			QList<QVariantList> vkeys;
+			GetSlotKeys (data, m_tabcol, vkeys);
+			for (int k = 0; k < vkeys.size(); k++) {
+				QString id = "";
+				for (int n = 0; n < vkeys.at(k).size(); n++)
+					id += (vkeys.at(k).at(n).isNull() ? QString("\x01") : vkeys.at(k).at(n).toString()) + "\x02";
+				if (seen.contains(id) == true)
+					continue;
+				seen.insert(id);
+				AddKeyRow (m_tabcol, &keys, vkeys.at(k));
+			}
+		}
+		tr.n = nChange;
+	}
+	QString tt = QString("Read  changes: finish (%1 sec), %2 changes of the table, %3 keys, up to lsn %4")
+				 .arg(timer.elapsed() / 1000., 0, 'f', 2).arg(nChange).arg(keys.m_tabdata.size()).arg(lsn.isEmpty() ? "-" : lsn);
+	printf ("%s\n", qPrintable(tt));
+	AddLog(m_tabcol, tt, false);
+
+	int err = TableKeys(pdbS, SqlDrvS, pdbD, SqlDrvD, numPolicy, m_tabcol, &keys, 0, &timer);
+
+	// all keys are synchronized: the slot is moved on. The check only, declined or ignored rows
+	// (the differences after the synchronization): the same changes next time
+	int rest = m_tabcol->total[1] + m_tabcol->total[2] + m_tabcol->total[3];
+	if (rest > 0 && lsn.isEmpty() == false)
+		AddLog(m_tabcol, QString("Slot %1 isn't moved: %2 rows aren't changed").arg(m_tabcol->slot).arg(rest), false);
+	if (nOther > 0) {	// the keys of other tables would be lost
+		tt = QString("Warning ! Slot %1 has %2 changes of other tables: it isn't moved (use the slot for one table only).").arg(m_tabcol->slot).arg(nOther);
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt, false);
+	}
+	if (err == 0 && rest == 0 && nOther == 0 && lsn.isEmpty() == false && IsRecovery(m_tabcol) == true) {
+		// w/o decoding again: after the commit of the last transaction (pg_lsn + numeric: 14+)
+		QString slot = QString(m_tabcol->slot).replace("'", "''");
+		sql = QString("select pg_replication_slot_advance('%1', '%2'::pg_lsn + 1)").arg(slot).arg(lsn);
+		QSqlQuery query(*pdbS);
+		if (query.exec(sql) == false) {
+			sql = QString("select pg_replication_slot_advance('%1', '%2')").arg(slot).arg(lsn);	// the last transaction is read again
+			if (query.exec(sql) == false)
+				return SaveErr (&query, sql, m_tabcol, -34);
+		}
+		AddLog(m_tabcol, "Slot " + m_tabcol->slot + " is moved to lsn " + lsn, false);
+	}
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+// pipelined processing: read -> hash -> compare -> apply, stages are connected by bounded queues
+#define PIPE_BATCH	1000		// rows in one block between the stages
+
+typedef struct _pipeline
+{
+	CPipeQueue<linetab*>		qReadS, qReadD;		// reader -> hasher
+	CPipeQueue<linetab*>		qHashS, qHashD;		// hasher -> comparison
+	CPipeQueue<QList<rowact> >	qAct;				// comparison -> apply
+
+	linetab		headS, headD;		// columns type & codec (set by the readers before the first block)
+	QAtomicInt	bAborted;
+	QString		DbErr    = "";
+	QString		ErrSql   = "";
+	QMutex		mtxErr;
+
+	void AbortAll (QString err, QString sql) {
+		mtxErr.lock();
+		if (bAborted.testAndSetOrdered(0, 1) == true) { DbErr = err; ErrSql = sql; }
+		mtxErr.unlock();
+		qReadS.Abort(); qReadD.Abort(); qHashS.Abort(); qHashD.Abort(); qAct.Abort();
+	}
+
+} pipeline;
+
+//-------------------------------------------------------------------------------------------------
+int NumTextCmp (QString x, QString y)	// compare decimal text ("-12.50", "3") w/o the precision loss of double
+{
+	bool negX = x.startsWith('-'), negY = y.startsWith('-');
+	if (negX != negY)
+		return (negX == true) ? -1 : 1;
+	if (negX == true) { x.remove(0, 1); y.remove(0, 1); }
+
+	QString ix = x.section('.', 0, 0), fx = x.section('.', 1);
+	QString iy = y.section('.', 0, 0), fy = y.section('.', 1);
+	while (ix.startsWith('0') == true)	ix.remove(0, 1);
+	while (iy.startsWith('0') == true)	iy.remove(0, 1);
+	while (fx.endsWith('0') == true)	fx.chop(1);
+	while (fy.endsWith('0') == true)	fy.chop(1);
+
+	int r = (ix.size() != iy.size()) ? ((ix.size() < iy.size()) ? -1 : 1) : ix.compare(iy);
+	if (r == 0)
+		r = fx.compare(fy);
+	r = (r < 0) ? -1 : (r > 0) ? 1 : 0;
+	return (negX == true) ? -r : r;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline int PipeVarCmp (int typeA, const QVariant& a, int typeB, const QVariant& b)	// compare key values (order by key, nulls last)
+{
+	if (a.isNull() == true || b.isNull() == true) {
+		if (a.isNull() == b.isNull())	return 0;
+		return (a.isNull() == true) ? 1 : -1;
+	}
+
+	auto isInt = [](int t) { return t == QVariant::Int || t == QVariant::UInt || t == QVariant::LongLong || t == QVariant::ULongLong; };
+	auto isNum = [&](int t) { return isInt(t) == true || t == QVariant::Double; };
+
+	// numbers: the integer form for whole numbers only (GetColTypes: float w/o precision is Int,
+	// the value can be a fraction or the text of HighPrecision)
+	if (isNum(typeA) == true && isNum(typeB) == true) {
+		qint64 i = 0, j = 0;
+		if (GetKeyInt(a, i) == true && GetKeyInt(b, j) == true)
+			return (i < j) ? -1 : (i > j) ? 1 : 0;
+		bool okA = false, okB = false;
+		double x = a.toDouble(&okA), y = b.toDouble(&okB);
+		if (okA == true && okB == true) {
+			if (x != y)
+				return (x < y) ? -1 : 1;
+			if (a.type() == QVariant::String && b.type() == QVariant::String)
+				return NumTextCmp(a.toString().trimmed(), b.toString().trimmed());
+			return 0;
+		}
+	}
+	if ((typeA == QVariant::DateTime || typeA == QVariant::Date) && (typeB == QVariant::DateTime || typeB == QVariant::Date)) {
+		qint64 x = a.toDateTime().toMSecsSinceEpoch(), y = b.toDateTime().toMSecsSinceEpoch();
+		return (x < y) ? -1 : (x > y) ? 1 : 0;
+	}
+	if (typeA == QVariant::Time && typeB == QVariant::Time) {
+		int x = a.toTime().msecsSinceStartOfDay(), y = b.toTime().msecsSinceStartOfDay();
+		return (x < y) ? -1 : (x > y) ? 1 : 0;
+	}
+
+	// strings (binary collation) and raw data
+	QByteArray x = (typeA == QVariant::ByteArray) ? a.toByteArray() : a.toString().toUtf8();
+	QByteArray y = (typeB == QVariant::ByteArray) ? b.toByteArray() : b.toString().toUtf8();
+	return (x < y) ? -1 : (x == y) ? 0 : 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline int PipeKeyCmp (const QList<int>& typeA, const QVariantList& a, const QList<int>& typeB, const QVariantList& b, const QList<int>& keys)
+{
+	for (int n = 0; n < keys.size(); n++) {
+		int indx = keys.at(n);
+		int r    = PipeVarCmp(typeA.at(indx), a.at(indx), typeB.at(indx), b.at(indx));
+		if (r != 0)
+			return r;
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// query sorted by key columns: the order of the rows must match PipeKeyCmp
+int GetPipeSql (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, QString& sql, QSql::NumericalPrecisionPolicy& numPolicy)
+{
+	QString nameRID = "DbSyncExtentKeyId";
+	QString cols    = "";
+	for (int i = 0; i < m_tabcol->col.size(); i++) {
+		if (i > 0)	cols += ",";
+		cols += m_tabcol->col.at(i).trimmed();
+	}
+
+	// columns type (empty result)
+	QSqlRecord rec;
+	if (GetColProbe(pdb, m_tabcol, rec) != 0)
+		return -41;
+
+	linetab types;
+	GetColTypes (rec, &types);
+	numPolicy = GetNumPolicy (rec);
+
+	QString order = "";
+	for (int n = 0; n < m_tabcol->poskey.size(); n++) {
+		int     indx = m_tabcol->poskey.at(n);
+		QString name = m_tabcol->col.at(indx).trimmed();
+		if (n > 0)	order += ",";
+
+		if (types.m_typeCol.at(indx) == QVariant::String) {		// byte order of the strings
+			if (SqlDrv == "QOCI")	order += "nlssort(" + name + ", 'NLS_SORT=BINARY')";
+			else					order += name + " collate \"C\"";
+		}
+		else {
+			order += name;
+		}
+	}
+
+	sql = "select " + cols + ",";
+	if (SqlDrv == "QOCI") {
+		sql += "t.rowid " + nameRID;	// to access the row to update
+	} else
+	if (SqlDrv == "QPSQL") {
+		sql += "ctid as " + nameRID;
+	} else {
+		printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
+		return -30;	// w/o rowid !!!
+	}
+	sql += " from " + m_tabcol->tab + " t";
+
+	if (m_tabcol->where.trimmed().isEmpty() == false) {
+		sql += " where ";
+		sql += m_tabcol->where.trimmed();
+	}
+	sql += " order by " + order;
+
+	// for debug
+	if (m_tabcol->bDebug == true) AddLog(m_tabcol, "  " + sql, false);
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+class CPipeThread : public QThread
+{
+public:
+	void run() override
+	{
+#ifdef CRASH_ON
+		crInstallToCurrentThread2(0);
+#endif
+		TraceThread (sName);
+		Work();
+#ifdef CRASH_ON
+		crUninstallFromCurrentThread();
+#endif
+	}
+	virtual void Work() = 0;
+
+	pipeline*	pPipe = nullptr;
+	qint64		nRows = 0;			// processed rows
+	QString		sName = "";			// for trace
+};
+
+//-------------------------------------------------------------------------------------------------
+class CPipeReader : public CPipeThread		// stage 1: read rows in key order
+{
+public:
+	void Work() override
+	{
+		CRowReader query(pDb);
+		if (query.Exec(SqlDrv, tsql, numPolicy) == false) {
+			pPipe->AbortAll(query.error().replace("\n", "; "), tsql);
+			return;
+		}
+
+		linetab& head = *pHead;
+		GetColTypes (query.record(), &head);
+		head.m_codec = GetRowCodec (head.m_typeCol);
+		int cntField = head.m_typeCol.size();
+
+		linetab* pbatch = nullptr;
+		while (query.Next()) {
+			if (pbatch == nullptr) {
+				pbatch = new linetab;
+				pbatch->m_typeCol = head.m_typeCol;
+				pbatch->m_codec   = head.m_codec;
+				pbatch->m_tabdata.reserve(PIPE_BATCH);
+			}
+			QVariantList mvlist;
+			mvlist.reserve(cntField);
+			for (int n = 0; n < cntField; n++)
+				mvlist.append(query.value(n));
+			pbatch->m_tabdata.append(mvlist);
+			nRows++;
+
+			if (pbatch->m_tabdata.size() >= PIPE_BATCH) {
+				bool b = pOut->Put(pbatch);
+				if (b == false)	delete pbatch;
+				pbatch = nullptr;
+				if (b == false) return;
+			}
+		}
+
+		if (query.isError() == true) {		// the connection is broken in the middle of the data
+			delete pbatch;
+			pPipe->AbortAll(query.error().replace("\n", "; "), tsql);
+			return;
+		}
+		if (pbatch != nullptr && pOut->Put(pbatch) == false)
+			delete pbatch;
+		pOut->Close();
+	}
+
+	QString					tsql = "";
+	QString					SqlDrv="";
+	QSqlDatabase*			pDb  = nullptr;
+	linetab*				pHead= nullptr;
+	QSql::NumericalPrecisionPolicy numPolicy = QSql::HighPrecision;
+	CPipeQueue<linetab*>*	pOut = nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------
+class CPipeHasher : public CPipeThread		// stage 2: checksum of the rows
+{
+public:
+	void Work() override
+	{
+		linetab*   pbatch = nullptr;
+		CRowHasher hasher;
+		while (pIn->Get(pbatch)) {
+			CTraceSpan tr("hash", QString(), pbatch->m_tabdata.size());
+			pbatch->m_crcline.reserve(pbatch->m_tabdata.size());
+			for (int i = 0; i < pbatch->m_tabdata.size(); i++)
+				hasher.Add (pbatch->m_tabdata.at(i), pbatch->m_codec, &pbatch->m_crcline);
+			hasher.Flush (&pbatch->m_crcline);
+			if (pbatch->m_tabdata.size() > 0 && pbatch->m_codec.ColUnsupp > 0) {
+				bUnsupport = true;
+				ColUnsupp  = pbatch->m_codec.ColUnsupp;
+			}
+			nRows += pbatch->m_tabdata.size();
+			if (pOut->Put(pbatch) == false) {
+				delete pbatch;
+				return;
+			}
+		}
+		pOut->Close();
+	}
+
+	CPipeQueue<linetab*>*	pIn  = nullptr;
+	CPipeQueue<linetab*>*	pOut = nullptr;
+	bool					bUnsupport = false;
+	int						ColUnsupp  = -1;
+};
+
+//-------------------------------------------------------------------------------------------------
+class CPipeCursor		// current row of the sorted stream
+{
+public:
+	~CPipeCursor() { delete pb; }
+
+	bool Valid() {		// false - end of data
+		while (pb == nullptr || pos >= pb->m_tabdata.size()) {
+			delete pb; pb = nullptr; pos = 0;
+			if (bEnd == true || pIn->Get(pb) == false) {
+				pb = nullptr; bEnd = true;
+				return false;
+			}
+		}
+		return true;
+	}
+	const QVariantList&	Row()	{ return pb->m_tabdata.at(pos); }
+	const QString&		Crc()	{ return pb->m_crcline.at(pos); }
+	const QList<int>&	Type()	{ return pb->m_typeCol; }
+
+	CPipeQueue<linetab*>*	pIn  = nullptr;
+	linetab*				pb   = nullptr;
+	int						pos  = 0;
+	bool					bEnd = false;
+};
+
+//-------------------------------------------------------------------------------------------------
+class CPipeCompare : public CPipeThread		// stage 3: merge of the sorted streams by key
+{
+public:
+	void Work() override
+	{
+		CTraceSpan tr("merge by key");
+		CPipeCursor curS, curD;
+		curS.pIn = &pPipe->qHashS;
+		curD.pIn = &pPipe->qHashD;
+
+		QList<rowact> acts;
+		int groups = 0;
+		for (;;) {
+			bool hs = curS.Valid();
+			bool hd = curD.Valid();
+			if (pPipe->bAborted.loadAcquire() != 0)	return;
+			if (hs == false && hd == false)			break;
+
+			int c = (hs == true && hd == true) ? PipeKeyCmp(curS.Type(), curS.Row(), curD.Type(), curD.Row(), *pKeys) : ((hs == true) ? -1 : 1);
+			QList<int>   keyType = (c <= 0) ? curS.Type() : curD.Type();
+			QVariantList key     = (c <= 0) ? curS.Row()  : curD.Row();
+
+			// rows with the same key
+			linetab gS, gD;
+			if (c <= 0 && Group(curS, keyType, key, &gS) == false)	return;
+			if (c >= 0 && Group(curD, keyType, key, &gD) == false)	return;
+
+			// the same classification as TableComparison (crc -> key)
+			for (int i = 0; i < gS.m_crcline.size(); i++) {
+				for (int j = 0; j < gD.m_crcline.size(); j++) {
+					if (gS.m_crcline.at(i) != gD.m_crcline.at(j)) continue;
+					gS.m_crcline.removeAt(i);	gS.m_tabdata.removeAt(i);
+					gD.m_crcline.removeAt(j);	gD.m_tabdata.removeAt(j);
+					i--; nIdentical++;
+					break;
+				}
+			}
+			while (gS.m_tabdata.size() > 0 && gD.m_tabdata.size() > 0) {
+				rowact act; act.mode = 2; act.rowS = gS.m_tabdata.takeFirst(); act.rowD = gD.m_tabdata.takeFirst();
+				acts.append(act);
+			}
+			for (int j = 0; j < gD.m_tabdata.size(); j++) {
+				rowact act; act.mode = 0; act.rowD = gD.m_tabdata.at(j);
+				acts.append(act);
+			}
+			for (int i = 0; i < gS.m_tabdata.size(); i++) {
+				rowact act; act.mode = 1; act.rowS = gS.m_tabdata.at(i);
+				acts.append(act);
+			}
 
-	QSqlQuery query0(*pdb);						// execute sql
-	bool b = query0.exec(cnttest);
-	if (b == false) 
-		return SaveErr (&query0, cnttest, m_tabcol, -33);
+			if (acts.size() >= PIPE_BATCH || (++groups >= PIPE_BATCH && acts.size() > 0)) {
+				if (pPipe->qAct.Put(acts) == false)	return;
+				acts.clear(); groups = 0;
+			}
+		}
+
+		if (acts.size() > 0 && pPipe->qAct.Put(acts) == false)
+			return;
+		pPipe->qAct.Close();
+	}
+
+	bool Group (CPipeCursor& cur, const QList<int>& keyType, const QVariantList& key, linetab* g)
+	{
+		while (cur.Valid() == true && PipeKeyCmp(cur.Type(), cur.Row(), keyType, key, *pKeys) == 0) {
+			g->m_tabdata.append(cur.Row());
+			g->m_crcline.append(cur.Crc());
+			cur.pos++;
+		}
+		if (pPipe->bAborted.loadAcquire() != 0)
+			return false;
+		if (cur.Valid() == true && PipeKeyCmp(cur.Type(), cur.Row(), keyType, key, *pKeys) < 0) {
+			pPipe->AbortAll("The rows are not sorted by key columns (collation of the database?)", "");
+			return false;
+		}
+		return true;
+	}
+
+	const QList<int>*	pKeys = nullptr;
+	int					nIdentical = 0;
+};
+
+//-------------------------------------------------------------------------------------------------
+// stage 4 (apply) works in the main thread: it owns the destination connection and asks the user
+int TablePipeline(QList<QSqlDatabase*> m_dbS, QString SqlDrvS, QList<QSqlDatabase*> m_dbD, QString SqlDrvD, tabcol* m_tabcol)
+{
+	printf ("\n------------------------------------------------------------------\n");
+	if (m_tabcol->poskey.size() < 1) {
+		printf ("Pipeline: key columns are not found in the table columns\n");
+		return -40;
+	}
+
+	QString sqlS = "", sqlD = "";
+	QSql::NumericalPrecisionPolicy numS, numD;
+	if (GetPipeSql(m_dbS.at(0), SqlDrvS, m_tabcol, sqlS, numS) != 0)	return -41;
+	if (GetPipeSql(m_dbD.at(0), SqlDrvD, m_tabcol, sqlD, numD) != 0)	return -41;
+
+	if (m_dbD.size() < 2) {		// the reader thread & the changes can't share a connection
+		printf ("Pipeline: the second connection of the destination isn't opened\n");
+		return -42;
+	}
+	QSqlDatabase* pdb = m_dbD.at(0);		// changes
+	QSqlDatabase* pdr = m_dbD.at(1);		// reading destination
+
+	AddLog(m_tabcol, "Table: " + m_tabcol->tab, false);
+	QString txt = "Columns: "; for (int b=0; b < m_tabcol->col.size(); b++)	txt += m_tabcol->col.at(b) + ";"; AddLog(m_tabcol, txt, false);
+
+	bool bChngeTrg = IsRecovery (m_tabcol);
+	SyncTriggers (pdb, SqlDrvD, m_tabcol, bChngeTrg, false);
+
+	AddLog(m_tabcol, QString("-----------------------------------------"));
+	AddLog(m_tabcol, QString("- Pipeline (key order):"));
+
+	pipeline pipe;
+	CPipeReader rdS, rdD;
+	CPipeHasher hsS, hsD;
+	CPipeCompare cmp;
+
+	rdS.pPipe = &pipe; rdS.pDb = m_dbS.at(0); rdS.tsql = sqlS; rdS.SqlDrv = SqlDrvS; rdS.pHead = &pipe.headS; rdS.pOut = &pipe.qReadS; rdS.numPolicy = numS;
+	rdD.pPipe = &pipe; rdD.pDb = pdr;         rdD.tsql = sqlD; rdD.SqlDrv = SqlDrvD; rdD.pHead = &pipe.headD; rdD.pOut = &pipe.qReadD; rdD.numPolicy = numD;
+	hsS.pPipe = &pipe; hsS.pIn = &pipe.qReadS; hsS.pOut = &pipe.qHashS;
+	hsD.pPipe = &pipe; hsD.pIn = &pipe.qReadD; hsD.pOut = &pipe.qHashD;
+	cmp.pPipe = &pipe; cmp.pKeys = &m_tabcol->poskey;
+	rdS.sName = "read Src"; rdD.sName = "read Dst"; hsS.sName = "hash Src"; hsD.sName = "hash Dst"; cmp.sName = "compare";
+
+	char txtTime[99];
+	QDateTime timeSql = QDateTime::currentDateTime();
+	printf ("Pipeline  : start\n");
+
+	rdS.start(); rdD.start(); hsS.start(); hsD.start(); cmp.start();
+
+	int  err = 0;
+	int  DuplicateRows = 0, DifferentRows = 0, UnnecessRows = 0, MissingRows = 0;
+
+	QList<rowact> acts;
+	while (pipe.qAct.Get(acts)) {
+		for (int k = 0; k < acts.size(); k++) {
+			const rowact& act = acts.at(k);
+
+			int nChangeRow = 1;
+			bool bDone = false;
+			int err0 = ApplyRowAct (pdb, SqlDrvD, m_tabcol, &pipe.headS, &pipe.headD, act, true, bDone);
+			if (bDone == true) { DuplicateRows++;  nChangeRow = 0; } else err  += err0;
+
+			if      (act.mode == 2)	DifferentRows += nChangeRow;
+			else if (act.mode == 0)	UnnecessRows  += nChangeRow;
+			else					MissingRows   += nChangeRow;
+		}
+	}
+
+	rdS.wait(); rdD.wait(); hsS.wait(); hsD.wait(); cmp.wait();
+	DuplicateRows += cmp.nIdentical;
+
+	// drop the blocks of the aborted pipeline
+	QList<linetab*> rest = pipe.qReadS.TakeAll() + pipe.qReadD.TakeAll() + pipe.qHashS.TakeAll() + pipe.qHashD.TakeAll();
+	qDeleteAll(rest);
+
+	int ThrWorks = timeSql.msecsTo(QDateTime::currentDateTime());
+	if (ThrWorks < 1000)	sprintf(txtTime, "%d msec", ThrWorks);
+	else					sprintf(txtTime, "%.2f sec", ThrWorks / 1000.);
+	printf ("Pipeline  : finish (%s), rows %lld / %lld\n", txtTime, rdS.nRows, rdD.nRows);
+
+	int unsupp = hsS.bUnsupport ? hsS.ColUnsupp : (hsD.bUnsupport ? hsD.ColUnsupp : -1);
+	if (unsupp > 0) {
+		QString errCol = QString ("  Warning ! Column type unsupported (%1)\n").arg(unsupp);
+		printf ("%s", qPrintable(errCol));
+		AddLog(m_tabcol, errCol, false);
+	}
+
+	if (pipe.bAborted.loadAcquire() != 0) {
+		printf ("SQL execution error: %s\n", qPrintable(pipe.DbErr));
+		AddLog(m_tabcol, "Err: " + pipe.DbErr, false);
+		AddLog(m_tabcol, "SQL: " + pipe.ErrSql, false);
+		AddLog(m_tabcol, " ");
+		err = (err != 0) ? err : -42;
+	}
+
+	SyncTriggers (pdb, SqlDrvD, m_tabcol, bChngeTrg, true);
+	PrintTotals  (m_tabcol, bChngeTrg, DuplicateRows, DifferentRows, UnnecessRows, MissingRows, err);
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+int ReadTableFile (QString fp, QStringList& filetab)	// lines of the TableFile
+{
+	int err = -2;
+	QFile file(fp);
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		err = 0; int linen = 0;
+		while (!file.atEnd()) {
+
+			QString str = QString::fromUtf8 (file.readLine());	// 2022 uft8 file
+			str			= str.trimmed();
+
+			filetab.append(str);
+			if (linen++ <= 2 && str.isEmpty() == true)	
+				err = -3;
+		}
+		file.close();	// fix
+	}
+	if (err != 0 || filetab.size() < 3) {
+		printf ("Error in 'TableFile' (#line. description): \n");
+		printf ("1. table columns\n");
+		printf ("2. key table columns\n");
+		printf ("3. table name\n");
+		printf ("4. [condition (where)]\n");
+		printf ("5. [trigger(s)]\n");
+		printf ("6. [stored row checksum column]\n");
 		
-	int cnt_rows = 0;
-	if (query0.next())							// read records
-		cnt_rows = query0.value(0).toInt();
+		printf ("\nfile: %s (%d lines)\n", qPrintable(fp), filetab.size());
+		for (int a=0; a<filetab.size();a++)
+			printf ("%d. %s\n", a, qPrintable(filetab.at(a)));
+		return -2;
+	}
+	return 0;
+}
 
-	printf ("Rows count: %d\n", cnt_rows);
-	printf ("Read  data: start\n");
+//-------------------------------------------------------------------------------------------------
+void SetTableFile (const QStringList& filetab, tabcol* m_tabcol)	// table data (processing)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+	m_tabcol->col	= filetab.at(0).split(",", Qt::SkipEmptyParts);
+	m_tabcol->colkey= filetab.at(1).split(",", Qt::SkipEmptyParts);
+	m_tabcol->tab	= filetab.at(2);
+	m_tabcol->where = (filetab.size() > 3) ? filetab.at(3) : "";
+	m_tabcol->trigg = (filetab.size() > 4) ? filetab.at(4).split(",", Qt::SkipEmptyParts) : QStringList();
+	m_tabcol->hashCol=(filetab.size() > 5) ? filetab.at(5) : "";
+#else
+	m_tabcol->col	= filetab.at(0).split(",", QString::SkipEmptyParts);
+	m_tabcol->colkey= filetab.at(1).split(",", QString::SkipEmptyParts);
+	m_tabcol->tab	= filetab.at(2);
+	m_tabcol->where = (filetab.size() > 3) ? filetab.at(3) : "";
+	m_tabcol->trigg = (filetab.size() > 4) ? filetab.at(4).split(",", QString::SkipEmptyParts) : QStringList();
+	m_tabcol->hashCol=(filetab.size() > 5) ? filetab.at(5) : "";
+#endif
 
-	//-----------------------------
-	QString sql0;
-	int n_beg = 0, n_end = 0, n_step = 1;
-	if (maxConnect == 1) {
-		// old postgresql
-		sql0= "select ";
-		for (int i = 0; i < m_tabcol->col.size(); i++) {
-			sql0 +=        m_tabcol->col.at(i).trimmed() + ",";
+	// get key column indexes
+	m_tabcol->poskey.clear();
+	for (int t = 0; t < m_tabcol->colkey.size(); t++) {
+		for (int m = 0; m < m_tabcol->col.size(); m++) {
+			if (m_tabcol->colkey.at(t).compare(m_tabcol->col.at(m), Qt::CaseInsensitive) == 0)
+				m_tabcol->poskey.append(m);	// key column position
 		}
+	}
+}
 
-		if (SqlDrv == "QOCI") {
-			sql0 += "t.rowid " + nameRID ;	// to access the row to update
-		} else
-		if (SqlDrv == "QPSQL") {
-			sql0 += "ctid as " + nameRID;
-		} else {
-			printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
-			return -30;	// w/o rowid !!!
+//-------------------------------------------------------------------------------------------------
+inline QString GetFilePath (QString fp, QString ext)	// TableFile.ext
+{
+	int indx = fp.lastIndexOf(".");
+	return (indx < 0) ? fp + ext : fp.mid(0, indx) + ext;
+}
+
+//-------------------------------------------------------------------------------------------------
+void SaveLog (tabcol* m_tabcol, QString pathlog)	// write log
+{
+	QFile ff (pathlog);
+	if (ff.open(QFile::WriteOnly) == true) {
+		ff.write (m_tabcol->logData.toUtf8());
+		ff.close ();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+// daemon: the tables of the schedule are checked periodically with the same connections
+typedef struct _daemontab
+{
+	QString		file	= "";		// TableFile
+	QStringList	filetab;			// lines of the TableFile
+	int			period	= 300;		// check period, sec
+	tabcol		tc;					// table & options
+
+	qint64		next	= 0;		// time of the next check, msec
+	QByteArray	digS, digD;			// digests of the tables (last check)
+	int			runs	= 0;		// checks
+	int			skips	= 0;		// checks w/o comparison (unchanged tables)
+	int			err		= 0;		// result of the last check
+	qint64		lastMs	= 0;		// duration of the last check, msec
+	QDateTime	lastTime;
+
+} daemontab;
+
+//-------------------------------------------------------------------------------------------------
+int GetSchedule (QString fp, QList<daemontab>& dtabs)	// lines: TableFile [period, sec]
+{
+	QFile file(fp);
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text) == false) {
+		printf ("Schedule file isn't found: %s\n", qPrintable(fp));
+		return -2;
+	}
+	QDir dir = QFileInfo(fp).absoluteDir();
+	while (!file.atEnd()) {
+		QString str = QString::fromUtf8 (file.readLine()).trimmed();
+		if (str.isEmpty() == true || str.startsWith("#") == true)
+			continue;
+
+		daemontab dt;
+		int indx = str.lastIndexOf(QRegExp("\\s"));
+		if (indx > 0 && str.mid(indx + 1).toInt() > 0) {
+			dt.period = str.mid(indx + 1).toInt();
+			str		  = str.mid(0, indx).trimmed();
 		}
-		sql0 += " from " + m_tabcol->tab;
+		dt.file = dir.absoluteFilePath(str).replace("\\", "/");
+		if (ReadTableFile(dt.file, dt.filetab) != 0)
+			return -2;
+		dtabs.append(dt);
+	}
+	file.close();
 
-		if (m_tabcol->where.isEmpty() == false) {
-			sql0 += " where ";
-			sql0 += m_tabcol->where;
+	if (dtabs.size() == 0) {
+		printf ("Schedule file has no tables: %s\n", qPrintable(fp));
+		return -2;
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+QByteArray GetTabDigest (linetab* m_lines)	// checksum of all rows (w/o order)
+{
+	QStringList crc = m_lines->m_crcline;
+	crc.sort();
+	QCryptographicHash hash(QCryptographicHash::Sha256);
+	for (int i = 0; i < crc.size(); i++)
+		hash.addData(crc.at(i).toLatin1());
+	return hash.result();
+}
+
+//-------------------------------------------------------------------------------------------------
+void DbAlive (QList<QSqlDatabase*> m_db, QString SqlDrv)	// reconnect the lost connections
+{
+	QString sql = (SqlDrv == "QOCI") ? "select 1 from dual" : "select 1";
+	for (int n = 0; n < m_db.size(); n++) {
+		QSqlDatabase* pdb = m_db.at(n);
+		{
+			QSqlQuery query(*pdb);
+			if (pdb->isOpen() == true && query.exec(sql) == true)
+				continue;
 		}
+		printf ("Connect Db: reconnect\n");
+		pdb->close();
+		if (pdb->open() == false)
+			printf ("Error during connecting to database: %s\n", qPrintable( pdb->lastError().text().replace("\n","; ") ));
+	}
+}
 
-		n_step= cnt_rows;
+//-------------------------------------------------------------------------------------------------
+void DaemonCheck (daemontab* dt, QList<QSqlDatabase*> m_dbS, QString SqlDrvS, QList<QSqlDatabase*> m_dbD, QString SqlDrvD)
+{
+	tabcol* m_tabcol = &dt->tc;
+	m_tabcol->logData.clear();
+
+	printf ("\n==================================================================\n");
+	printf ("%s  %s\n", qPrintable(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")), qPrintable(dt->file));
+
+	QElapsedTimer timer;
+	timer.start();
+
+	DbAlive (m_dbS, SqlDrvS);
+	DbAlive (m_dbD, SqlDrvD);
+
+	int err = 0;
+	linetab linesSrc, linesDst;
+	for (;;) {
+		if (GetDataTable(m_dbS, SqlDrvS, m_tabcol, &linesSrc) != 0) { err = -11; break; }
+		if (GetDataTable(m_dbD, SqlDrvD, m_tabcol, &linesDst) != 0) { err = -13; break; }
+
+		QByteArray digS = GetTabDigest(&linesSrc), digD = GetTabDigest(&linesDst);
+		bool bSame = (dt->runs > 0 && dt->err == 0 && digS == dt->digS && digD == dt->digD);
+		dt->digS = digS;
+		dt->digD = digD;
+
+		// only both digests unchanged: a changed table is compared again even if the last check found no differences
+		if (bSame == true && (IsRecovery(m_tabcol) == false || m_tabcol->total[1] + m_tabcol->total[2] + m_tabcol->total[3] == 0)) {
+			dt->skips++;	// the result is the same as the last check
+			printf ("Tables are unchanged since the last check.\n");
+			AddLog(m_tabcol, "Table: " + m_tabcol->tab + " (unchanged)", false);
+			break;
+		}
+		if (digS == digD) {	// all rows are identical
+			PrintTotals (m_tabcol, false, linesSrc.m_crcline.size(), 0, 0, 0, 0);
+			break;
+		}
+		err = TableComparison(m_dbD.at(0), SqlDrvD, m_tabcol, &linesSrc, &linesDst);
+		break;
 	}
-	else {
-		// 
-		// multi processing - prepare requests for several threads
-		QString sql1= "";
-		QString sql2= "";
-		QString sqlw= "";
-		for (int i = 0; i < m_tabcol->col.size(); i++) {
-			sql1 +=        m_tabcol->col.at(i).trimmed() + ",";
-			sql2 += "t." + m_tabcol->col.at(i).trimmed() + ",";
+
+	dt->err		= err;
+	dt->lastMs	= timer.elapsed();
+	dt->lastTime= QDateTime::currentDateTime();
+	dt->runs++;
+	printf ("Check: %.2f sec\n", dt->lastMs / 1000.);
+
+	if (m_tabcol->bLog == true)
+		SaveLog (m_tabcol, GetFilePath(dt->file, ".log"));
+	m_tabcol->logData.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+QString GetLabelStr (const QString& v)	// value of the label (metrics): \\, \", \n
+{
+	return QString(v).replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+}
+
+//-------------------------------------------------------------------------------------------------
+QString GetDaemonStatus (QList<daemontab>& dtabs, qint64 upMs)	// metrics (text format of Prometheus)
+{
+	const char* state[4] = { "identical", "different", "unnecessary", "missing" };
+	QString r = QString("dbsync_up_seconds %1\n").arg(upMs / 1000);
+	for (int k = 0; k < dtabs.size(); k++) {
+		const daemontab& dt = dtabs.at(k);
+		QString lb = QString("{file=\"%1\",table=\"%2\"}").arg(GetLabelStr(QFileInfo(dt.file).fileName()), GetLabelStr(dt.tc.tab));
+		r += "dbsync_checks_total"  + lb + QString(" %1\n").arg(dt.runs);
+		r += "dbsync_checks_skipped"+ lb + QString(" %1\n").arg(dt.skips);
+		if (dt.runs == 0)
+			continue;
+		r += "dbsync_check_error"   + lb + QString(" %1\n").arg(dt.err);
+		r += "dbsync_check_seconds" + lb + QString(" %1\n").arg(dt.lastMs / 1000., 0, 'f', 3);
+		r += "dbsync_check_time"    + lb + QString(" %1\n").arg(dt.lastTime.toMSecsSinceEpoch() / 1000);
+		for (int t = 0; t < 4 && dt.err == 0; t++)
+			r += "dbsync_rows" + lb.mid(0, lb.size() - 1) + QString(",state=\"%1\"} %2\n").arg(state[t]).arg(dt.tc.total[t]);
+	}
+	return r;
+}
+
+//-------------------------------------------------------------------------------------------------
+class CStatusThread : public QThread	// status of the daemon on the local port: text or HTTP GET, "stop" - finish
+{
+public:
+	void run() override
+	{
+		QTcpServer server;
+		if (server.listen(QHostAddress::LocalHost, port) == false) {
+			printf ("Status port %d isn't opened: %s\n", port, qPrintable(server.errorString()));
+			return;
 		}
-		sql1 += nameRID;
+		while (bStop == 0) {
+			if (server.waitForNewConnection(200) == false)
+				continue;
+			QTcpSocket* ps = server.nextPendingConnection();
+			if (ps == nullptr)
+				continue;
 
-		if (SqlDrv == "QOCI") {
-			sql2 += "t.rowid " + nameRID + ", ";	// to access the row to update
-			sql2 += "rownum " + nameRNM + " ";		// to fetch a specific piece of data (part of select)
-			sqlw  = "t.rowid";						// data acquisition identity
-		} else
-		if (SqlDrv == "QPSQL") {
-			sql2 += "ctid as " + nameRID + ", ";
-			sql2 += "row_number() over() as " + nameRNM + " ";
-			sqlw  = "ctid";
-		} else {
-			printf ("SQL-driver determination error: %s\n", qPrintable (SqlDrv));
-			return -30;	// w/o rowid !!!
+			ps->waitForReadyRead(500);
+			QByteArray req = ps->readAll();
+			if (req.trimmed() == "stop")
+				bStop = 1;
+
+			mtx.lock();
+			QByteArray txt = status.toUtf8();
+			mtx.unlock();
+			if (req.startsWith("GET") == true)
+				txt = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + QByteArray::number(txt.size()) + "\r\n\r\n" + txt;
+
+			ps->write(txt);
+			ps->waitForBytesWritten(1000);
+			ps->disconnectFromHost();
+			if (ps->state() != QAbstractSocket::UnconnectedState)
+				ps->waitForDisconnected(1000);
+			delete ps;
 		}
+	}
+	void SetStatus (QString txt)
+	{
+		mtx.lock();
+		status = txt;
+		mtx.unlock();
+	}
 
-		sql0  = "select ";
-		sql0 += sql1;
-		sql0 += " from (select ";
-		sql0 += sql2;
-		sql0 += " from " + m_tabcol->tab;
-		sql0 += " t ";
-		if (m_tabcol->where.isEmpty() == false) {
-			sql0 += " where ";
-			sql0 += m_tabcol->where;
+	int			port  = 0;
+	QAtomicInt	bStop;
+	QMutex		mtx;
+	QString		status= "";
+};
+
+//-------------------------------------------------------------------------------------------------
+int TableDaemon(QList<daemontab>& dtabs, QList<QSqlDatabase*> m_dbS, QString SqlDrvS, QList<QSqlDatabase*> m_dbD, QString SqlDrvD, int port)
+{
+	QElapsedTimer clock;
+	clock.start();
+
+	CStatusThread st;
+	st.port = port;
+	st.SetStatus(GetDaemonStatus(dtabs, 0));
+	st.start();
+	printf ("Daemon: %d table(s), status: localhost:%d\n", dtabs.size(), port);
+
+	while (st.bStop == 0) {
+		int next = 0;	// the nearest check
+		for (int k = 1; k < dtabs.size(); k++)
+			if (dtabs.at(k).next < dtabs.at(next).next) next = k;
+
+		qint64 wait = dtabs.at(next).next - clock.elapsed();
+		if (wait > 0) {
+			QThread::msleep(qMin(wait, (qint64)200));
+			continue;
 		}
-		sql0 += " order by ";
-		sql0 += sqlw;
-		sql0 += ") ";
 
-		if (SqlDrv == "QPSQL") {	// fix Postgresql - alias for:  FROM (SELECT ...) [AS] foo
-			sql0 += "as DbSyncCursorTable ";
-		}
+		daemontab* dt = &dtabs[next];
+		DaemonCheck (dt, m_dbS, SqlDrvS, m_dbD, SqlDrvD);
+		dt->next = clock.elapsed() + dt->period * 1000LL;
+		st.SetStatus(GetDaemonStatus(dtabs, clock.elapsed()));
+	}
+
+	st.wait();
+	printf ("Daemon: stop\n");
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// one source into several destinations: the rows of the source are read once and shared by all
+// destinations (implicit sharing of Qt containers: a destination copies only what it changes)
+#define FANOUT_MAX		16			// destinations
+
+typedef struct _fanout
+{
+	QString					drv		= "";	// destination
+	QString					alias	= "";
+	QString					pathlog	= "";
+	QList<QSqlDatabase*>	db;
+	tabcol					tc;				// log, journal & totals of the destination
+	int						err		= 0;
+	qint64					ms		= 0;	// duration
+
+} fanout;
+
+class CFanoutThread : public QThread	// read, compare & apply of one destination
+{
+public:
+	void run() override
+	{
+#ifdef CRASH_ON
+		crInstallToCurrentThread2(0);
+#endif
+		TraceThread (QString("destination #%1").arg(Instance + 1));
+		QElapsedTimer timer;
+		timer.start();
+		linetab linesS = *pLinesS, linesD;	// the same rows of the source
+		if (GetDataTable(pf->db, pf->drv, &pf->tc, &linesD) != 0)	pf->err = -13;
+		else pf->err = TableComparison(pf->db.at(0), pf->drv, &pf->tc, &linesS, &linesD);
+		pf->ms = timer.elapsed();
+#ifdef CRASH_ON
+		crUninstallFromCurrentThread();
+#endif
+	}
+
+	fanout*			pf		= nullptr;
+	const linetab*	pLinesS	= nullptr;
+	int				Instance= 0;
+};
 
-		n_beg = 0; n_end = 0; n_step = 10 + cnt_rows / maxConnect;
-		n_step = (n_step / 10) * 10;
+//-------------------------------------------------------------------------------------------------
+int TableFanout (linetab* m_linesS, QList<fanout>& dst)	// all destinations at the same time, then the summary
+{
+	QList<CFanoutThread*> thr;
+	for (int k = 0; k < dst.size(); k++) {
+		CFanoutThread* p = new CFanoutThread;
+		p->pf		= &dst[k];
+		p->pLinesS	= m_linesS;
+		p->Instance	= k;
+		thr.append(p);
+	}
+	{
+		CTraceSpan tr("destinations", QString(), dst.size());
+		for (int k = 0; k < thr.size(); k++)	thr.at(k)->start();
+		for (int k = 0; k < thr.size(); k++)	thr.at(k)->wait();
+	}
+	qDeleteAll(thr);
 
-		if (cnt_rows / maxConnect <= 10) {				// little data = 1 thread
-			maxConnect = 1;
-			n_step     = 10 + cnt_rows;
-		}
+	int err = 0;
+	printf ("\n==================================================================\n");
+	printf ("Destinations (identical / different / unnecessary / missing rows):\n");
+	for (int k = 0; k < dst.size(); k++) {
+		const fanout& f = dst.at(k);
+		QString tt = QString("  #%1 %2 %3: %4 / %5 / %6 / %7, %8 sec").arg(k + 1).arg(f.drv).arg(f.alias).
+			arg(f.tc.total[0]).arg(f.tc.total[1]).arg(f.tc.total[2]).arg(f.tc.total[3]).arg(f.ms / 1000., 0, 'f', 2);
+		if (f.err != 0)	tt += QString(", error %1").arg(f.err);
+		printf ("%s\n", qPrintable(tt));
+		if (f.err != 0 && err == 0)
+			err = f.err;
 	}
+	return err;
+}
 
-	CMyDbThread pThr[22];							// max 10 thread (protected)
-	for (int n = 0; n < maxConnect; n++) {			// threads get data in parts from the all rows: 1..10, 11..20, 21..30 and etc.
+//-------------------------------------------------------------------------------------------------
+// partitioned tables: the partitions with the same names, bounds & partition key on both sides are
+// processed as separate tables (read, compare, apply) by the connections of -m at the same time.
+// The partitions with the same row count & checksum (computed on the servers, the same driver only) are skipped
+typedef struct _partunit
+{
+	QString		name	= "";		// partition (w/o schema)
+	QString		tabS	= "";		// partition of the source (table ref)
+	QString		tabD	= "";		// partition of the destination
+	tabcol		tc;					// table data of the partition (tab - partition, log)
+	int			err		= 0;
+	bool		bSkip	= false;	// the same checksum
+	qint64		ms		= 0;
 
-		QString ssql= sql0;
-		if (maxConnect != 1) {
-			n_end		= n_beg + n_step;			// so the database client loads the entire network channel			
-			if (n < maxConnect - 1)	ssql += QString ("where %1>=%2 and %3<%4").arg(nameRNM).arg (n_beg).arg(nameRNM).arg (n_end);
-			else					ssql += QString ("where %1>=%2").arg(nameRNM).arg (n_beg);
-		}
+} partunit;
+
+//-------------------------------------------------------------------------------------------------
+// partitions of the table: names, table refs, bounds & partition key ("RANGE (id)"). -35: subpartitions (QPSQL)
+int GetPartitions (QSqlDatabase* pdb, QString SqlDrv, tabcol* m_tabcol, QStringList& names, QStringList& refs, QStringList& bounds, QString& pkey)
+{
+	QString tab = m_tabcol->tab.trimmed(), alias = "", sql;
+	int sp = tab.indexOf(' ');		// table alias
+	if (sp > 0) {
+		alias = " " + tab.mid(sp + 1).trimmed();
+		tab   = tab.left(sp);
+	}
+	QString sqlk;
+	if (SqlDrv == "QPSQL") {
+		QString qtab = QString(tab).replace("'", "''");
+		sqlk = "select pg_get_partkeydef('" + qtab + "'::regclass)";
+		sql  = "select t.relid::text, pg_get_expr(c.relpartbound, c.oid), t.level from pg_partition_tree('" + qtab + "') t "
+			   "join pg_class c on c.oid=t.relid where t.isleaf and t.level > 0 order by 1";
+	}
+	else
+	if (SqlDrv == "QOCI") {
+		int dot = tab.indexOf('.');
+		QString owner = (dot > 0) ? "upper('" + tab.left(dot) + "')" : "user";
+		sqlk = "select p.partitioning_type, k.column_name from all_part_tables p join all_part_key_columns k on k.owner=p.owner and "
+			   "k.name=p.table_name and k.object_type='TABLE' where p.owner=" + owner + " and p.table_name=upper('" + tab.mid(dot + 1) + "') order by k.column_position";
+		sql  = "select partition_name, partition_position, high_value from all_tab_partitions where table_owner=" + owner +
+			   " and table_name=upper('" + tab.mid(dot + 1) + "') order by partition_position";
+	}
+	else
+		return -30;
+
+	if (m_tabcol->bDebug == true) AddLog(m_tabcol, "  " + sqlk + "\n  " + sql, false);
+	QSqlQuery queryk(*pdb);
+	if (queryk.exec(sqlk) == false)		// old version, no rights, not partitioned: w/o partitions
+		return -34;
+	QStringList kc;
+	while (queryk.next()) {
+		if (SqlDrv == "QPSQL")	pkey = queryk.value(0).toString();
 		else {
+			pkey = queryk.value(0).toString();
+			kc.append(queryk.value(1).toString());
 		}
+	}
+	if (SqlDrv == "QOCI" && kc.size() > 0)
+		pkey += " (" + kc.join(", ") + ")";
+	if (pkey.isEmpty() == true)
+		return -34;
 
-		n_beg			= n_end;
-		pThr[n].tsql	= ssql;
-		pThr[n].pDb		= m_db.at(n);
-		pThr[n].Instance= n;
-		pThr[n].maxRow	= 1.5 * n_step;
+	QSqlQuery query(*pdb);
+	if (query.exec(sql) == false)
+		return -34;
+	while (query.next()) {
+		QString p = query.value(0).toString(), n = QString(p).remove('"');
+		if (SqlDrv == "QPSQL" && query.value(2).toInt() > 1)
+			return -35;
+		names.append(n.mid(n.lastIndexOf('.') + 1).toLower());
+		refs.append(((SqlDrv == "QOCI") ? tab + " partition (" + p + ")" : p) + alias);
+		bounds.append((SqlDrv == "QOCI") ? query.value(1).toString() + ": " + query.value(2).toString() : query.value(1).toString());	// Oracle hash: position
 	}
+	return 0;
+}
 
-	char txtTime[99];
-	QDateTime timeSql = QDateTime::currentDateTime();
+//-------------------------------------------------------------------------------------------------
+// the columns of the partition key are the columns of the TableFile key (w/o expressions)
+bool IsPartKeyInKey (tabcol* m_tabcol, const QString& pkey)
+{
+	QStringList keys;
+	for (int n = 0; n < m_tabcol->poskey.size(); n++) {
+		QString c = m_tabcol->col.at(m_tabcol->poskey.at(n)).trimmed().remove('"').toLower();
+		keys.append(c.mid(c.lastIndexOf('.') + 1));
+	}
+	int b = pkey.indexOf('('), e = pkey.lastIndexOf(')');
+	if (b < 0 || e <= b)
+		return false;
+	QStringList pc = pkey.mid(b + 1, e - b - 1).split(',');
+	for (int n = 0; n < pc.size(); n++)
+		if (keys.contains(pc.at(n).trimmed().remove('"').toLower()) == false)
+			return false;
+	return true;
+}
 
-	for (int nn=0; nn < maxConnect; nn++) 		pThr[nn].start();	
-	for (int nn=0; nn < maxConnect; nn++)		pThr[nn].wait();	// waiting for all threads
+//-------------------------------------------------------------------------------------------------
+QString GetPartSumSql (QString SqlDrv, tabcol* m_tabcol)	// rows & checksum of the partition (order of the rows isn't used)
+{
+	QString cols = "";
+	for (int i = 0; i < m_tabcol->col.size(); i++) {
+		QString c = m_tabcol->col.at(i).trimmed();
+		if (SqlDrv == "QPSQL")	cols += ((i > 0) ? "," : "") + c;
+		else					cols += ((i > 0) ? "||'|'||" : "") + c;
+	}
+	QString sql;
+	if (SqlDrv == "QPSQL")	sql = "select count(*), coalesce(sum(('x'||substr(md5(row(" + cols + ")::text),1,8))::bit(32)::bigint),0)::text from " + m_tabcol->tab;
+	else					sql = "select count(*), to_char(nvl(sum(ora_hash(" + cols + ")),0)) from " + m_tabcol->tab;
+	if (m_tabcol->where.isEmpty() == false)
+		sql += " where (" + m_tabcol->where + ")";
+	return sql;
+}
 
-	int ThrWorks = timeSql.msecsTo(QDateTime::currentDateTime());
-	if (ThrWorks < 1000)	sprintf(txtTime, "%d msec", ThrWorks);
-	else					sprintf(txtTime, "%.2f sec", ThrWorks / 1000.);
+//-------------------------------------------------------------------------------------------------
+class CPartThread : public QThread		// partitions by turns: one connection of each side
+{
+public:
+	void run() override
+	{
+#ifdef CRASH_ON
+		crInstallToCurrentThread2(0);
+#endif
+		TraceThread (QString("partitions #%1").arg(Instance + 1));
+		for (;;) {
+			int n = pNext->fetchAndAddOrdered(1);
+			if (n >= pUnits->size())
+				break;
+			partunit* pu = &(*pUnits)[n];
+			QElapsedTimer timer;
+			timer.start();
+			CTraceSpan tr("partition", pu->name);
+
+			// the same rows & checksum: w/o reading
+			if (SqlDrvS == SqlDrvD && SetHashNls(pdbS, SqlDrvS, &pu->tc) == 0 && SetHashNls(pdbD, SqlDrvD, &pu->tc) == 0) {
+				pu->tc.tab = pu->tabS;	QString sqlS = GetPartSumSql(SqlDrvS, &pu->tc);
+				pu->tc.tab = pu->tabD;	QString sqlD = GetPartSumSql(SqlDrvD, &pu->tc);
+				QSqlQuery qS(*pdbS), qD(*pdbD);
+				if (qS.exec(sqlS) == true && qS.next() == true && qD.exec(sqlD) == true && qD.next() == true &&
+					qS.value(0).toLongLong() == qD.value(0).toLongLong() && qS.value(1).toString() == qD.value(1).toString()) {
+					pu->bSkip = true;
+					pu->tc.total[0] = qS.value(0).toInt();
+					pu->ms = timer.elapsed();
+					continue;
+				}
+			}
 
-	int unsupp	= -1;
-	int CodErr  = 0;
-	QString Err = "", ErrSql = "";
-	for (int nn = 0; nn < maxConnect; nn++) {	
-		// if one of the threads did not fulfill the database request - stop!
-		if (pThr[nn].CodeErr != 0) {
-			CodErr  = pThr[nn].CodeErr;
-			Err		= pThr[nn].DbErr;
-			ErrSql	= pThr[nn].tsql;
-			break;
+			linetab linesS, linesD;
+			QList<QSqlDatabase*> dbS, dbD;
+			dbS << pdbS;	dbD << pdbD;
+			pu->tc.tab = pu->tabS;
+			int errS = GetDataTable(dbS, SqlDrvS, &pu->tc, &linesS);
+			pu->tc.tab = pu->tabD;		// the changes: the partition of the destination
+			if		(errS != 0)													pu->err = -11;
+			else if (GetDataTable(dbD, SqlDrvD, &pu->tc, &linesD) != 0)		pu->err = -13;
+			else pu->err = TableComparison(pdbD, SqlDrvD, &pu->tc, &linesS, &linesD);
+			pu->ms = timer.elapsed();
 		}
+#ifdef CRASH_ON
+		crUninstallFromCurrentThread();
+#endif
+	}
 
-		if (pThr[0].m_lines.b_Unsuppt == true && nn == 0) 
-			unsupp = pThr[0].m_lines.ColUnsupp;
-			
-		// save data from all threads to the output-list
-		m_lines->m_crcline.append(pThr[nn].m_lines.m_crcline);
-		m_lines->m_tabdata.append(pThr[nn].m_lines.m_tabdata);
-		if (m_lines->m_typeCol.size() == 0) {
-			m_lines->m_typeCol.append(pThr[nn].m_lines.m_typeCol);
-			m_lines->m_nameCol.append(pThr[nn].m_lines.m_nameCol);
-		}
-		// free
-		pThr[nn].m_lines.m_crcline.clear();
-		pThr[nn].m_lines.m_tabdata.clear();
-		pThr[nn].m_lines.m_typeCol.clear();
-		pThr[nn].m_lines.m_nameCol.clear();
+	QSqlDatabase*		pdbS	= nullptr;
+	QSqlDatabase*		pdbD	= nullptr;
+	QString				SqlDrvS	= "";
+	QString				SqlDrvD	= "";
+	QList<partunit>*	pUnits	= nullptr;
+	QAtomicInt*			pNext	= nullptr;
+	int					Instance= 0;
+};
+
+//-------------------------------------------------------------------------------------------------
+// 1 - w/o partitions (not partitioned, not the same on both sides): the whole table
+int TablePartitions (QList<QSqlDatabase*> m_dbS, QString SqlDrvS, QList<QSqlDatabase*> m_dbD, QString SqlDrvD, tabcol* m_tabcol)
+{
+	QStringList namesS, refsS, boundsS, namesD, refsD, boundsD;
+	QString pkeyS, pkeyD;
+	if (GetPartitions(m_dbS.at(0), SqlDrvS, m_tabcol, namesS, refsS, boundsS, pkeyS) != 0 ||
+		GetPartitions(m_dbD.at(0), SqlDrvD, m_tabcol, namesD, refsD, boundsD, pkeyD) != 0 || namesS.size() == 0) {
+		printf ("The table isn't partitioned (or has subpartitions): the whole table is processed.\n");
+		return 1;
+	}
+	// a row must be in the partition of the same name on both sides: the same key & bounds
+	QString why = "";
+	QStringList sortS = namesS, sortD = namesD;
+	sortS.sort();	sortD.sort();
+	if (sortS != sortD)
+		why = QString("partitions aren't the same (%1 Src, %2 Dst)").arg(namesS.size()).arg(namesD.size());
+	else if (SqlDrvS != SqlDrvD)
+		why = "bounds can't be compared (" + SqlDrvS + " Src, " + SqlDrvD + " Dst)";
+	else if (pkeyS != pkeyD)
+		why = "partition keys aren't the same (" + pkeyS + " Src, " + pkeyD + " Dst)";
+	else if (IsPartKeyInKey(m_tabcol, pkeyD) == false)
+		why = "partition key (" + pkeyD + ") isn't a part of the key of the TableFile";
+	for (int k = 0; k < namesD.size() && why.isEmpty() == true; k++)
+		if (boundsD.at(k) != boundsS.at(namesS.indexOf(namesD.at(k))))
+			why = "bounds of the partition " + namesD.at(k) + " aren't the same";
+	if (why.isEmpty() == false) {
+		QString tt = "Warning ! The " + why + ": the whole table is processed.";
+		printf ("%s\n", qPrintable(tt));
+		AddLog(m_tabcol, tt, false);
+		return 1;
 	}
 
-	if (CodErr != 0) {
-		printf ("SQL execution error: %s\n", qPrintable(Err));
-		AddLog(m_tabcol, "Err: " + Err, false);
-		AddLog(m_tabcol, "SQL: " + ErrSql, false);
-		AddLog(m_tabcol, " ");
-		return -1;
+	QList<partunit> units;
+	bool bTrgSess = (m_tabcol->bTrgSess == true && SqlDrvD == "QPSQL");	// session: for each connection
+	for (int k = 0; k < namesD.size(); k++) {
+		partunit pu;
+		pu.name		  = namesD.at(k);
+		pu.tabS		  = refsS.at(namesS.indexOf(pu.name));
+		pu.tabD		  = refsD.at(k);
+		pu.tc		  = *m_tabcol;
+		pu.tc.tab	  = pu.tabD;
+		pu.tc.logData = "";
+		pu.tc.pathJrn = "";		// w/o journal (resume - the whole table)
+		if (bTrgSess == false)
+			pu.tc.trigg.clear();	// once for the table
+		units.append(pu);
 	}
 
- 	printf ("Read  data: finish (%s)\n\n", txtTime);
-	
-	if (m_lines->m_tabdata.size() != cnt_rows)
-		printf ("  Warning ! Received rows %d of %d\n", m_lines->m_tabdata.size(), cnt_rows);
-	if (unsupp > 0) {
-		QString errCol = QString ("  Warning ! Column type unsupported (%1)\n").arg(unsupp);
-		printf ("%s", qPrintable(errCol));
-		AddLog(m_tabcol, errCol, false);
+	QElapsedTimer timer;
+	timer.start();
+	printf ("Partitions: %d, connections: %d\n", units.size(), qMin(m_dbS.size(), m_dbD.size()));
+
+	bool bChngeTrg = IsRecovery(m_tabcol);
+	if (bTrgSess == false)
+		SyncTriggers (m_dbD.at(0), SqlDrvD, m_tabcol, bChngeTrg, false);
+	for (int k = 0; k < units.size(); k++)
+		units[k].tc.bIgnAll = m_tabcol->bIgnAll;	// the triggers aren't disabled: w/o changes
+
+	QAtomicInt next(0);
+	QList<CPartThread*> thr;
+	for (int k = 0; k < qMin(m_dbS.size(), m_dbD.size()) && k < units.size(); k++) {
+		CPartThread* p = new CPartThread;
+		p->pdbS	= m_dbS.at(k);	p->SqlDrvS = SqlDrvS;
+		p->pdbD	= m_dbD.at(k);	p->SqlDrvD = SqlDrvD;
+		p->pUnits = &units;		p->pNext = &next;
+		p->Instance = k;
+		thr.append(p);
 	}
-	printf ("\n");
-	return 0;
+	{
+		CTraceSpan tr("partitions", m_tabcol->tab, units.size());
+		for (int k = 0; k < thr.size(); k++)	thr.at(k)->start();
+		for (int k = 0; k < thr.size(); k++)	thr.at(k)->wait();
+	}
+	qDeleteAll(thr);
+
+	if (bTrgSess == false)
+		SyncTriggers (m_dbD.at(0), SqlDrvD, m_tabcol, bChngeTrg, true);
+
+	// the summary & the log of the partitions (in order)
+	int err = 0, nSkip = 0, total[4] = { 0, 0, 0, 0 };
+	printf ("\n==================================================================\n");
+	printf ("Partitions (identical / different / unnecessary / missing rows):\n");
+	for (int k = 0; k < units.size(); k++) {
+		const partunit& pu = units.at(k);
+		QString tt = QString("  %1: %2 / %3 / %4 / %5, %6 sec").arg(pu.name).
+			arg(pu.tc.total[0]).arg(pu.tc.total[1]).arg(pu.tc.total[2]).arg(pu.tc.total[3]).arg(pu.ms / 1000., 0, 'f', 2);
+		if (pu.bSkip == true)	tt += ", the same checksum (w/o reading)";
+		if (pu.err != 0)		tt += QString(", error %1").arg(pu.err);
+		printf ("%s\n", qPrintable(tt));
+		m_tabcol->logData += pu.tc.logData;
+		AddLog(m_tabcol, tt, false);
+		for (int t = 0; t < 4; t++)	total[t] += pu.tc.total[t];
+		if (pu.bSkip == true)	nSkip++;
+		if (pu.err != 0 && err == 0)
+			err = pu.err;
+	}
+	QString tt = QString("Partitions: %1, skipped %2 (the same checksum), %3 sec").arg(units.size()).arg(nSkip).arg(timer.elapsed() / 1000., 0, 'f', 2);
+	printf ("%s\n", qPrintable(tt));
+	AddLog(m_tabcol, tt, false);
+	PrintTotals (m_tabcol, bChngeTrg, total[0], total[1], total[2], total[3], err);
+	return err;
+}
+
+//-------------------------------------------------------------------------------------------------
+// benchmark of the row checksum: rows of TestTab (example), one thread
+int BenchHash ()
+{
+	const int nRows = 200000;
+	QList<int> types;
+	types << QVariant::Int << QVariant::Int << QVariant::String << QVariant::String << QVariant::DateTime << QVariant::ByteArray << QVariant::String;
+
+	tabdata rows;
+	rows.reserve(nRows);
+	QDateTime dt = QDateTime::currentDateTime();
+	for (int i = 0; i < nRows; i++) {
+		QVariantList vl;
+		vl << QVariant(348) << QVariant(i) << QVariant(QString("row %1").arg(i).leftJustified(100, ' '))
+		   << QVariant(QString("varchar data of the row %1").arg(i * 7)) << QVariant(dt.addSecs(i))
+		   << QVariant(QByteArray(64, char(i & 0xff))) << QVariant(QString("(%1,%2)").arg(i / 100).arg(i % 100));
+		rows.append(vl);
+	}
+	rowcodec codec = GetRowCodec(types);
+	int cpu = Sha3CpuLanes();
+	printf ("Row checksum (SHA3-512), %d rows, 1 thread. CPU: %s\n\n", nRows, (cpu == 8) ? "AVX-512" : (cpu == 4) ? "AVX2" : "scalar");
+
+	// current path
+	QStringList crc0;
+	crc0.reserve(nRows);
+	QElapsedTimer tm; tm.start();
+	bool bUnsupport = false; int ColUnsupp = -1;
+	for (int i = 0; i < nRows; i++) {
+		QVariantList vl = rows.at(i);
+		crc0.append(GetCrc(&vl, &types, bUnsupport, ColUnsupp));
+	}
+	double t0 = qMax((qint64)1, tm.elapsed()) / 1000.;
+	printf ("  QCryptographicHash      : %9.0f rows/s\n", nRows / t0);
+
+	int err = 0;
+	int lanes[3] = { 1, 4, 8 };
+	for (int l = 0; l < 3; l++) {
+		if (lanes[l] > cpu)
+			continue;
+		QStringList crc;
+		crc.reserve(nRows);
+		CRowHasher hasher;
+		hasher.lanes = lanes[l];
+		tm.restart();
+		for (int i = 0; i < nRows; i++)
+			hasher.Add(rows.at(i), codec, &crc);
+		hasher.Flush(&crc);
+		double t = qMax((qint64)1, tm.elapsed()) / 1000.;
+		bool bSame = (crc == crc0);
+		if (bSame == false) err = -1;
+		printf ("  codec + sha3.h, %d row(s): %9.0f rows/s  x%.2f  %s\n", lanes[l], nRows / t, t0 / t, bSame ? "same digests" : "DIGESTS DIFFER !");
+	}
+	return err;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -959,7 +5076,8 @@ QList <QSqlDatabase*> GetDb(QString db, QString drv, QStringList& list, const ch
 {
 	QList <QSqlDatabase*> listDb;
 
-	QSqlDatabase  xx = QSqlDatabase::addDatabase(drv, QString("DbSync.%1").arg(QTime::currentTime().msecsSinceStartOfDay()));
+	static int nDb = 0;		// the names of the connections must be unique (several destinations)
+	QSqlDatabase  xx = QSqlDatabase::addDatabase(drv, QString("DbSync.%1.%2").arg(++nDb).arg(QTime::currentTime().msecsSinceStartOfDay()));
 	if (list.size() < 3) { 
 		printf ("Error in %s Db connection settings\n", name);	
 		return listDb;	
@@ -996,7 +5114,7 @@ QList <QSqlDatabase*> GetDb(QString db, QString drv, QStringList& list, const ch
 
 	// multiple connections
 	for (int n = 1; n < m; n++) {
-		QSqlDatabase test = QSqlDatabase::cloneDatabase(xx, QString("DbSync.%1.%2.%d").arg(n).arg(QTime::currentTime().msecsSinceStartOfDay()));
+		QSqlDatabase test = QSqlDatabase::cloneDatabase(xx, QString("DbSync.%1.%2.%3").arg(nDb).arg(n).arg(QTime::currentTime().msecsSinceStartOfDay()));
 		QSqlDatabase* p2  = new QSqlDatabase(test);
 		if (p2->open() == true)
 			listDb.append(p2);
@@ -1006,6 +5124,23 @@ QList <QSqlDatabase*> GetDb(QString db, QString drv, QStringList& list, const ch
 }
 
 
+//-------------------------------------------------------------------------------------------------
+QString GetDbAlias (QString db, QStringList& list)	// user / password @ db : addr * port -> w/o password
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+	list = db.split(QRegExp("[/@:*]"), Qt::SkipEmptyParts);
+#else
+	list = db.split(QRegExp("[/@:*]"), QString::SkipEmptyParts);
+#endif
+	QString alias = "unknown";
+	if (list.size() >= 3) {
+		alias = list.at(0) + "/***@" + list.at(2);
+		if (list.size() >= 4) alias += ":" + list.at(3);
+		if (list.size() >= 5) alias += "*" + list.at(4);
+	}
+	return alias;
+}
+
 //-------------------------------------------------------------------------------------------------
 int main(int argc, char *argv[])
 {
@@ -1029,6 +5164,7 @@ int main(int argc, char *argv[])
 	parser.addPositionalArgument			("Source",			"Db: user/password@alias or user/password@db[:addr*port]");
 	parser.addPositionalArgument			("DrvDst",			"SQL Driver name for connecting: QOCI,QPSQL,...");
 	parser.addPositionalArgument			("Destination",		"Db: user/password@alias or user/password@db[:addr*port]");
+	parser.addPositionalArgument			("[DrvDst2 Destination2 ...]", "More destinations: the source is read once, the destinations are synchronized at the same time.");
 
 	QCommandLineOption showAutoActionConf	("y",				"Confirm the automatic actions.");
 	QCommandLineOption showIgnoreAllOption	("x",				"Show differences in tables only.");
@@ -1037,9 +5173,30 @@ int main(int argc, char *argv[])
 	QCommandLineOption showIgnoreDelOption	("d",				"Ignore rows deletion.");
 	QCommandLineOption showLogOption        ("l",				"Write down to the log file.");
 	QCommandLineOption showTriggOption      ("t",				"Disable trigger execution (off/on).");
+	QCommandLineOption showTriggSession     ("r",				"Disable triggers for own session only (PostgreSQL: session_replication_role).");
 	QCommandLineOption showMaxConnect       ("m",				"The number of concurrent database connections (1-20).", "connections");
 	QCommandLineOption showMaxLineWdt       ("n",				"Symbols quantity limit in the log file line (50-999).", "limit");
 	QCommandLineOption saveDebugInfo        ("b",				"Writing additional debugging information.");
+	QCommandLineOption showMaxRate          ("rate",			"Apply throttling: max changed rows per second.", "rows");
+	QCommandLineOption showMaxLatency       ("max-latency",		"Apply throttling: slow down if a statement is longer (msec).", "msec");
+	QCommandLineOption showMaxLag           ("max-lag",			"Apply throttling: pause while the replication lag is greater (sec).", "sec");
+	QCommandLineOption showLagSql           ("lag-sql",			"Query of the replication lag in seconds (default for QPSQL: pg_stat_replication).", "sql");
+	QCommandLineOption showResume           ("resume",			"Continue the changes of the journal (w/o reading the tables).");
+	QCommandLineOption showBenchHash        ("bench-hash",		"Benchmark of the row checksum (rows/s per core).");
+	QCommandLineOption showSample           ("sample",			"Estimate the differences on a random sample of the rows (percent), w/o changes.", "percent");
+	QCommandLineOption showDaemon           ("daemon",			"Service mode: TableFile is a schedule (TableFile [period, sec] per line), status on the local port.", "port");
+	QCommandLineOption showTrace            ("trace",			"Write the timeline of the run (Chrome trace / Perfetto JSON).", "file");
+	QCommandLineOption showSetApply         ("set-apply",		"Apply the changes as one set (QPSQL): staging table, delete and merge in one transaction.");
+	QCommandLineOption showChanges          ("changes",			"Compare only the keys changed since the last run: logical replication slot of the source (QPSQL, test_decoding), one slot per table.", "slot");
+	QCommandLineOption showServerJoin       ("server-join",		"Compare on the destination server (FULL OUTER JOIN): source table as seen from the destination Db.", "table");
+	QCommandLineOption showAsyncApply       ("async-apply",		"Apply on QPSQL in libpq pipeline mode: statements w/o waiting, one transaction per batch of rows.", "rows");
+	QCommandLineOption showPartitions       ("partitions",		"Process the partitions of the table (the same on both sides) in parallel by the connections of -m, skip the partitions with the same checksum.");
+	QCommandLineOption showExplain          ("explain",			"Write the plans of the generated statements (once per shape), server & client time into the log.");
+	QCommandLineOption showExplainAn        ("explain-analyze",	"--explain with the execution of insert, update, delete for the plan (PostgreSQL, rolled back: triggers fire, sequences advance).");
+	QCommandLineOption showVerify           ("verify",			"Verify the changed rows and a sample of the rows (0 - w/o sample) on the destination after the changes.", "rows");
+	QCommandLineOption showReadRetry        ("read-retry",		"Attempts again for a failed part of the table reading, on a new connection (default 2).", "attempts");
+	QCommandLineOption showAsyncRead        ("async-read",		"Read the parts of the table (QPSQL) by one thread with asynchronous queries of libpq.");
+	QCommandLineOption showPipeline         ("p",				"Pipelined processing: read, compare and apply rows in key order with bounded memory.");
 
 	parser.addOption  (showAutoActionConf);
 	parser.addOption  (showLogOption);
@@ -1048,17 +5205,47 @@ int main(int argc, char *argv[])
 	parser.addOption  (showIgnoreInsOption);
 	parser.addOption  (showIgnoreDelOption);
 	parser.addOption  (showTriggOption);
+	parser.addOption  (showTriggSession);
 	parser.addOption  (showMaxConnect);
+	parser.addOption  (showReadRetry);
+	parser.addOption  (showVerify);
+	parser.addOption  (showPartitions);
+	parser.addOption  (showExplain);
+	parser.addOption  (showExplainAn);
+	parser.addOption  (showAsyncRead);
 	parser.addOption  (showMaxLineWdt);
 	parser.addOption  (saveDebugInfo);
+	parser.addOption  (showPipeline);
+	parser.addOption  (showResume);
+	parser.addOption  (showSetApply);
+	parser.addOption  (showAsyncApply);
+	parser.addOption  (showSample);
+	parser.addOption  (showServerJoin);
+	parser.addOption  (showChanges);
+	parser.addOption  (showDaemon);
+	parser.addOption  (showTrace);
+	parser.addOption  (showBenchHash);
+	parser.addOption  (showMaxRate);
+	parser.addOption  (showMaxLatency);
+	parser.addOption  (showMaxLag);
+	parser.addOption  (showLagSql);
 
 	printf ("LeonSoft - %s %s\n\n", qPrintable(QCoreApplication::applicationName()), qPrintable(QCoreApplication::applicationVersion()));
 
 	// тут может вылететь, например на ключе -v
 	parser.process(a);// Process the actual command line arguments given by the user
 
+	if (parser.isSet(showTrace)) {	// profiling
+		g_trace.bOn = true;
+		g_trace.timer.start();
+		TraceThread ("main");
+	}
+
+	if (parser.isSet(showBenchHash))
+		return BenchHash();
+
 	const QStringList args	= parser.positionalArguments();	// db connection
-	if (args.size() != 5) {
+	if (args.size() < 5 || args.size() % 2 != 1 || args.size() > 3 + 2 * FANOUT_MAX) {
 		parser.showHelp();
 		return -1;
 	}
@@ -1068,67 +5255,24 @@ int main(int argc, char *argv[])
 	QString dbDrvSrc	= args.at(1);
 	QString dbDrvDst	= args.at(3);
 	// user / password @ db : addr * port
-	QString sdb_alias	= "unknown";
-
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-	QStringList slist	= args.at(2).split(QRegExp("[/@:*]"), Qt::SkipEmptyParts);
-#else
-	QStringList slist	= args.at(2).split(QRegExp("[/@:*]"), QString::SkipEmptyParts);
-#endif
-
-	if (slist.size() >= 3) {
-		sdb_alias = slist.at(0) + "/***@" + slist.at(2);
-		if (slist.size() >= 4) sdb_alias += ":" + slist.at(3);
-		if (slist.size() >= 5) sdb_alias += "*" + slist.at(4);
-	}
-	QString ddb_alias	= "unknown";
-
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-	QStringList dlist	= args.at(4).split(QRegExp("[/@:*]"), Qt::SkipEmptyParts);
-#else
-	QStringList dlist	= args.at(4).split(QRegExp("[/@:*]"), QString::SkipEmptyParts);
-#endif
-	if (dlist.size() >= 3) {
-		ddb_alias = dlist.at(0) + "/***@" + dlist.at(2);
-		if (dlist.size() >= 4) ddb_alias += ":" + dlist.at(3);		
-		if (dlist.size() >= 5) ddb_alias += "*" + dlist.at(4);
-	}
+	QStringList slist, dlist;
+	QString sdb_alias	= GetDbAlias(args.at(2), slist);
+	QString ddb_alias	= GetDbAlias(args.at(4), dlist);
 
 	// for log-file (path)
 	QDir dir;
 	QString		fp  = dir.absoluteFilePath(targetFile).replace("\\", "/");
-	int     indxlog = fp.lastIndexOf(".");
-	QString pathlog = (indxlog < 0) ? fp + ".log" : fp.mid(0, indxlog) + ".log";
+	QString pathlog = GetFilePath(fp, ".log");
+	QString pathjrn = GetFilePath(fp, ".journal");
 
 	// file-tab
-	tabcol	m_tabcol; QStringList filetab;	int err = -2;
-	QFile file(fp);
-	if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-		err = 0; int linen = 0;
-		while (!file.atEnd()) {
-
-			QString str = QString::fromUtf8 (file.readLine());	// 2022 uft8 file
-			str			= str.trimmed();
-
-			filetab.append(str);
-			if (linen++ <= 2 && str.isEmpty() == true)	
-				err = -3;
-		}
-		file.close();	// fix
-	}
-	if (err != 0 || filetab.size() < 3) {
-		printf ("Error in 'TableFile' (#line. description): \n");
-		printf ("1. table columns\n");
-		printf ("2. key table columns\n");
-		printf ("3. table name\n");
-		printf ("4. [condition (where)]\n");
-		printf ("5. [trigger(s)]\n");
-		
-		printf ("\nfile: %s (%d lines)\n", qPrintable(fp), filetab.size());
-		for (int a=0; a<filetab.size();a++)
-			printf ("%d. %s\n", a, qPrintable(filetab.at(a)));
+	tabcol	m_tabcol; QStringList filetab;	int err = 0;
+	QList<daemontab> dtabs;
+	bool bDaemon = parser.isSet(showDaemon);
+	if (bDaemon == true)	err = GetSchedule  (fp, dtabs);		// TableFile is the schedule
+	else					err = ReadTableFile(fp, filetab);
+	if (err != 0)
 		return -2;
-	}
 
 #ifdef WIN32
 	{
@@ -1220,27 +5364,8 @@ int main(int argc, char *argv[])
 #endif
 
 	// table data (processing)
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-	m_tabcol.col	= filetab.at(0).split(",", Qt::SkipEmptyParts);
-	m_tabcol.colkey = filetab.at(1).split(",", Qt::SkipEmptyParts);
-	m_tabcol.tab	= filetab.at(2);
-	m_tabcol.where  = (filetab.size() > 3) ? filetab.at(3) : "";
-	m_tabcol.trigg  = (filetab.size() > 4) ? filetab.at(4).split(",", Qt::SkipEmptyParts) : QStringList();
-#else
-	m_tabcol.col	= filetab.at(0).split(",", QString::SkipEmptyParts);
-	m_tabcol.colkey = filetab.at(1).split(",", QString::SkipEmptyParts);
-	m_tabcol.tab	= filetab.at(2);
-	m_tabcol.where  = (filetab.size() > 3) ? filetab.at(3) : "";
-	m_tabcol.trigg  = (filetab.size() > 4) ? filetab.at(4).split(",", QString::SkipEmptyParts) : QStringList();
-#endif
-
-	// get key column indexes
-	for (int t = 0; t < m_tabcol.colkey.size(); t++) {
-		for (int m = 0; m < m_tabcol.col.size(); m++) {
-			if (m_tabcol.colkey.at(t).compare(m_tabcol.col.at(m), Qt::CaseInsensitive) == 0)
-				m_tabcol.poskey.append(m);	// key column position
-		}
-	}
+	if (bDaemon == false)
+		SetTableFile (filetab, &m_tabcol);
 
 	m_tabcol.bLog   = parser.isSet(showLogOption);
 	m_tabcol.bIgnAll= parser.isSet(showIgnoreAllOption);
@@ -1248,10 +5373,28 @@ int main(int argc, char *argv[])
 	m_tabcol.bIgnIns= parser.isSet(showIgnoreInsOption);
 	m_tabcol.bIgnDel= parser.isSet(showIgnoreDelOption);
 	m_tabcol.bIgnTRG= parser.isSet(showTriggOption);
+	m_tabcol.bTrgSess=parser.isSet(showTriggSession);
 	m_tabcol.bAAC	= parser.isSet(showAutoActionConf);
 	m_tabcol.bDebug = parser.isSet(saveDebugInfo); // debug
+	m_tabcol.bPipe  = parser.isSet(showPipeline);
+	m_tabcol.bResume= parser.isSet(showResume);
+	m_tabcol.bSetApply=parser.isSet(showSetApply);
+	m_tabcol.joinSrc= parser.value(showServerJoin).trimmed();
+	m_tabcol.slot	= parser.value(showChanges).trimmed();
+	m_tabcol.bPartitions = parser.isSet(showPartitions);
+	m_tabcol.bExplainAn = parser.isSet(showExplainAn);
+	m_tabcol.bExplain = parser.isSet(showExplain) || m_tabcol.bExplainAn;
+	m_tabcol.pathJrn= pathjrn;
+	// the journal is valid for the same TableFile and databases only
+	QString identDb = "\n" + dbDrvSrc + " " + sdb_alias + "\n" + dbDrvDst + " " + ddb_alias;
+	m_tabcol.identJrn = QCryptographicHash::hash((filetab.join("\n") + identDb).toUtf8(), QCryptographicHash::Sha256);
 	m_tabcol.maxQSymb=-1;
 
+	if (parser.isSet(showSample)) {	// check only
+		m_tabcol.sample  = qBound(0.000001, parser.value(showSample).toDouble(), 99.);
+		m_tabcol.bIgnAll = true;
+	}
+
 	if (m_tabcol.bIgnAll == true) {	// 2022 fix
 		m_tabcol.bIgnUpd = m_tabcol.bIgnIns = m_tabcol.bIgnDel = true;
 	}
@@ -1261,6 +5404,46 @@ int main(int argc, char *argv[])
 		multDB = parser.value(showMaxConnect).toInt();
 	if (multDB > 20)	multDB = 20;	// protection
 	if (multDB < 1)		multDB = 1;
+	m_tabcol.bAsyncRead = parser.isSet(showAsyncRead);
+#ifndef LIBPQ_ON
+	if (m_tabcol.bAsyncRead == true) {
+		printf ("Warning ! Asynchronous reading isn't compiled (LIBPQ_ON), the parts are read by the threads.\n");
+		m_tabcol.bAsyncRead = false;
+	}
+#endif
+	if (parser.isSet(showReadRetry))
+		m_tabcol.readRetry = qBound(0, parser.value(showReadRetry).toInt(), 10);
+	if (parser.isSet(showVerify))
+		m_tabcol.verify = qBound(0, parser.value(showVerify).toInt(), VERIFY_MAX);
+
+	// apply throttling
+	if (parser.isSet(showMaxRate))		m_tabcol.thr.maxRate = qMax(0., parser.value(showMaxRate).toDouble());
+	if (parser.isSet(showMaxLatency))	m_tabcol.thr.maxLat  = qMax(0,  parser.value(showMaxLatency).toInt());
+	if (parser.isSet(showMaxLag))		m_tabcol.thr.maxLag  = qMax(0., parser.value(showMaxLag).toDouble());
+	if (parser.isSet(showLagSql))		m_tabcol.thr.lagSql  = parser.value(showLagSql);
+	else if (dbDrvDst == "QPSQL")		m_tabcol.thr.lagSql  = "select coalesce(extract(epoch from max(replay_lag)), 0) from pg_stat_replication";
+	if (m_tabcol.thr.maxLag > 0 && m_tabcol.thr.lagSql.isEmpty() == true) {
+		printf ("Warning ! Lag query isn't set (--lag-sql), the lag isn't controlled.\n");
+		m_tabcol.thr.maxLag = 0;
+	}
+
+	if (m_tabcol.bSetApply == true && (dbDrvDst != "QPSQL" || IsThrottle(&m_tabcol) == true || m_tabcol.bPipe == true)) {
+		printf ("Warning ! Set apply is supported for QPSQL w/o throttling and pipeline, the rows are changed one by one.\n");
+		m_tabcol.bSetApply = false;
+	}
+
+	if (parser.isSet(showAsyncApply)) {
+		int rows = parser.value(showAsyncApply).toInt();
+		m_tabcol.asyncBatch = (rows > 0) ? qMin(rows, ASYNC_MAX) : ASYNC_BATCH;
+#if !defined(LIBPQ_ON) || !defined(LIBPQ_HAS_PIPELINING)
+		printf ("Warning ! Pipeline mode of libpq isn't compiled (LIBPQ_ON, libpq 14+), the rows are changed one by one.\n");
+		m_tabcol.asyncBatch = 0;
+#endif
+		if (m_tabcol.asyncBatch > 0 && (dbDrvDst != "QPSQL" || IsThrottle(&m_tabcol) == true || m_tabcol.bPipe == true)) {
+			printf ("Warning ! Async apply is supported for QPSQL w/o throttling and pipeline, the rows are changed one by one.\n");
+			m_tabcol.asyncBatch = 0;
+		}
+	}
 
 	if (parser.isSet(showMaxLineWdt)) {
 		m_tabcol.maxQSymb = parser.value(showMaxLineWdt).toInt();
@@ -1268,10 +5451,44 @@ int main(int argc, char *argv[])
 		if (m_tabcol.maxQSymb > 999)	m_tabcol.maxQSymb = 999;
 	}
 
+	// daemon: the options are the same for all tables of the schedule
+	bool bTrigg = m_tabcol.trigg.size() > 0;
+	for (int k = 0; k < dtabs.size(); k++) {
+		daemontab& dt = dtabs[k];
+		dt.tc = m_tabcol;
+		SetTableFile (dt.filetab, &dt.tc);
+		dt.tc.pathJrn  = GetFilePath(dt.file, ".journal");
+		dt.tc.identJrn = QCryptographicHash::hash((dt.filetab.join("\n") + identDb).toUtf8(), QCryptographicHash::Sha256);
+		if (dt.tc.trigg.size() > 0) bTrigg = true;
+	}
+
+	// several destinations: own log, journal & totals for each
+	QList<fanout> fan;
+	for (int k = 3; args.size() > 5 && k < args.size(); k += 2) {
+		fanout f;
+		QStringList flist;
+		int   n = (k - 3) / 2 + 1;
+		f.drv   = args.at(k);
+		f.alias = GetDbAlias(args.at(k + 1), flist);
+		f.tc    = m_tabcol;
+		f.pathlog     = (n == 1) ? pathlog : GetFilePath(fp, QString(".%1.log").arg(n));
+		f.tc.pathJrn  = (n == 1) ? pathjrn : GetFilePath(fp, QString(".%1.journal").arg(n));
+		f.tc.identJrn = QCryptographicHash::hash((filetab.join("\n") + "\n" + dbDrvSrc + " " + sdb_alias + "\n" + f.drv + " " + f.alias).toUtf8(), QCryptographicHash::Sha256);
+		fan.append(f);
+	}
+
 	// show : 
 	printf ("==================================================================\n");
 	printf ("Source Db : %s  %s\n", qPrintable(dbDrvSrc), qPrintable(sdb_alias));
 	printf ("Destin Db : %s  %s\n", qPrintable(dbDrvDst), qPrintable(ddb_alias));
+	for (int k = 1; k < fan.size(); k++)
+	printf ("Destin #%d: %s  %s\n", k + 1, qPrintable(fan.at(k).drv), qPrintable(fan.at(k).alias));
+	if (bDaemon == true) {
+	printf ("Schedule  : %s\n", qPrintable(targetFile));
+	for (int k = 0; k < dtabs.size(); k++)
+	printf ("  %-8s: %s (%d sec)\n", qPrintable(dtabs.at(k).tc.tab), qPrintable(dtabs.at(k).file), dtabs.at(k).period);
+	}
+	else {
 	printf ("TableFile : %s\n", qPrintable(targetFile));
 	printf ("  column  : %s\n", qPrintable(filetab.at(0)));
 	printf ("  key col.: %s\n", qPrintable(filetab.at(1)));
@@ -1286,6 +5503,7 @@ int main(int argc, char *argv[])
 	printf ("  triggers: %s\n", qPrintable(filetab.at(4)));
 	else
 	printf ("  triggers: *NONE*\n");
+	}
 
 	printf ("  \n");
 
@@ -1294,16 +5512,41 @@ int main(int argc, char *argv[])
 	if ((m_tabcol.bIgnAll == true) ||	// all ignore
 		(m_tabcol.bIgnIns == true && m_tabcol.bIgnDel == true && m_tabcol.bIgnUpd == true)) bChngeTrg = false;
 
-	if (m_tabcol.trigg.size() > 0      &&
+	if (bTrigg				  == true  &&
 		m_tabcol.bIgnTRG      != true  &&
 		bChngeTrg		      == true)	
 	{
-		printf ("Attention! You must have rights to disable trigger(s).\n\n");
+		if (m_tabcol.bTrgSess == true && dbDrvDst == "QPSQL") {
+			printf ("Attention! Triggers and foreign keys are disabled for DbSync session only.\n");
+			printf ("           You must have rights to set session_replication_role.\n\n");
+		}
+		else {
+			if (m_tabcol.bTrgSess == true)
+				printf ("Attention! Session mode of triggers is supported for QPSQL only.\n");
+			printf ("Attention! You must have rights to disable trigger(s).\n\n");
+		}
 	}
 
 	if (bChngeTrg == false) {
 		printf ("\n*** CHECK ONLY ***\n\n");
 	}
+	else
+	if (bDaemon == true && m_tabcol.bAAC == false) {
+		printf ("Daemon mode: use -x (check only) or -y (confirm the automatic actions).\n");
+		return -1;
+	}
+	if (fan.size() > 0 && (bDaemon == true || m_tabcol.bResume == true || m_tabcol.sample > 0 || m_tabcol.bPipe == true || m_tabcol.joinSrc.isEmpty() == false || m_tabcol.slot.isEmpty() == false)) {
+		printf ("Several destinations: the full comparison only (w/o --daemon, --resume, --sample, --server-join, --changes, -p).\n");
+		return -1;
+	}
+	if (fan.size() > 0 && bChngeTrg == true && m_tabcol.bAAC == false) {
+		printf ("Several destinations: use -x (check only) or -y (confirm the automatic actions).\n");
+		return -1;
+	}
+	if (m_tabcol.bPartitions == true && bChngeTrg == true && m_tabcol.bAAC == false) {	// the partitions are changed at the same time
+		printf ("Partitions: use -x (check only) or -y (confirm the automatic actions).\n");
+		return -1;
+	}
 
 	// for debug
 	if (m_tabcol.bDebug == true)  AddLog(&m_tabcol, ">> SQL\n", false);
@@ -1314,11 +5557,99 @@ int main(int argc, char *argv[])
 	err = 0; linetab linesSrc, linesDst;
 	for (;;)
 	{
+		if (bDaemon == true) {	// the connections are kept between the checks
+			listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", multDB);
+			if (listSrcDb.size() == 0) { err = -10; break; }
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", multDB);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TableDaemon(dtabs, listSrcDb, dbDrvSrc, listDstDb, dbDrvDst, parser.value(showDaemon).toInt());
+			break;
+		}
+
+		if (m_tabcol.bResume == true) {	// w/o reading the tables
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", 1);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TableResume(listDstDb.at(0), dbDrvDst, &m_tabcol);
+			break;
+		}
+
+		if (m_tabcol.sample > 0) {		// estimate by a part of the rows
+			listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", 1);
+			if (listSrcDb.size() == 0) { err = -10; break; }
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", 1);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TableSample(listSrcDb.at(0), dbDrvSrc, listDstDb.at(0), dbDrvDst, &m_tabcol);
+			break;
+		}
+
+		if (m_tabcol.joinSrc.isEmpty() == false) {	// only the different rows are read
+			listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", 1);
+			if (listSrcDb.size() == 0) { err = -10; break; }
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", 1);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TableServerJoin(listSrcDb.at(0), dbDrvSrc, listDstDb.at(0), dbDrvDst, &m_tabcol);
+			break;
+		}
+
+		if (m_tabcol.slot.isEmpty() == false) {	// only the keys of the slot changes
+			listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", 1);
+			if (listSrcDb.size() == 0) { err = -10; break; }
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", 1);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TableChanges(listSrcDb.at(0), dbDrvSrc, listDstDb.at(0), dbDrvDst, &m_tabcol);
+			break;
+		}
+
+		if (m_tabcol.hashCol.isEmpty() == false && m_tabcol.bPipe == false && fan.size() == 0) {	// stored checksums, then the different rows
+			listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", 1);
+			if (listSrcDb.size() == 0) { err = -10; break; }
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", 1);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TableStoredHash(listSrcDb.at(0), dbDrvSrc, listDstDb.at(0), dbDrvDst, &m_tabcol);
+			break;
+		}
+
+		if (m_tabcol.bPartitions == true && m_tabcol.bPipe == false && fan.size() == 0) {	// the partitions in parallel
+			listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", multDB);
+			if (listSrcDb.size() == 0) { err = -10; break; }
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", multDB);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TablePartitions(listSrcDb, dbDrvSrc, listDstDb, dbDrvDst, &m_tabcol);
+			if (err != 1)
+				break;
+			err = 0;	// the whole table
+			if (GetDataTable(listSrcDb, dbDrvSrc, &m_tabcol, &linesSrc) != 0) { err = -11; break; }
+			if (GetDataTable(listDstDb, dbDrvDst, &m_tabcol, &linesDst) != 0) { err = -13; break; }
+			err = TableComparison(listDstDb.at(0), dbDrvDst, &m_tabcol, &linesSrc, &linesDst);
+			break;
+		}
+
 		// get Source -------
-		listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", multDB);
+		listSrcDb = GetDb(args.at(2), dbDrvSrc, slist, "source", (m_tabcol.bPipe == true) ? 1 : multDB);
 		if (listSrcDb.size() == 0) { err = -10; break; }
+
+		if (m_tabcol.bPipe == true) {	// read, compare and apply at the same time
+			listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", 2);
+			if (listDstDb.size() == 0) { err = -12; break; }
+			err = TablePipeline(listSrcDb, dbDrvSrc, listDstDb, dbDrvDst, &m_tabcol);
+			break;
+		}
+
 		if (GetDataTable(listSrcDb, dbDrvSrc, &m_tabcol, &linesSrc) != 0) { err = -11; break; }
 
+		if (fan.size() > 0) {	// the rows of the source for all destinations
+			for (int k = 0; k < fan.size() && err == 0; k++) {
+				QStringList flist;
+				GetDbAlias(args.at(3 + 2 * k + 1), flist);
+				fan[k].db = GetDb(args.at(3 + 2 * k + 1), fan.at(k).drv, flist, qPrintable(QString("destination #%1").arg(k + 1)), multDB);
+				listDstDb.append(fan.at(k).db);		// for closing
+				if (fan.at(k).db.size() == 0) err = -12;
+			}
+			if (err == 0)
+				err = TableFanout(&linesSrc, fan);
+			break;
+		}
+
 		// get Destin -------
 		listDstDb = GetDb(args.at(4), dbDrvDst, dlist, "destination", multDB);
 		if (listDstDb.size() == 0) { err = -12; break; }
@@ -1344,13 +5675,12 @@ int main(int argc, char *argv[])
 	}
 
 	// write log
-	if (m_tabcol.bLog == true) {
-		QFile ff (pathlog);
-		if (ff.open(QFile::WriteOnly) == true) {
-			ff.write (m_tabcol.logData.toUtf8());
-			ff.close ();
-		}
-	}
+	if (m_tabcol.bLog == true && bDaemon == false && fan.size() == 0)
+		SaveLog (&m_tabcol, pathlog);
+	for (int k = 0; k < fan.size() && m_tabcol.bLog == true; k++)
+		SaveLog (&fan[k].tc, fan.at(k).pathlog);
+	if (g_trace.bOn == true)
+		TraceSave (parser.value(showTrace));
 #ifdef CRASH_ON
 	crUninstall();	
 #endif
@@ -0,0 +1,209 @@
+#pragma once
+//
+// SHA3-512 (FIPS 202) for the checksums of the rows.
+// Several rows are hashed at once: AVX-512 - 8 rows, AVX2 - 4 rows, otherwise one by one.
+// The instruction set is selected at run time, the digests are the same for all of them.
+//
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #define SHA3_X86
+ #include <immintrin.h>
+ #ifdef _MSC_VER
+  #include <intrin.h>
+  #define SHA3_TARGET(x)
+ #else
+  #define SHA3_TARGET(x) __attribute__((target(x)))
+ #endif
+#endif
+
+#define SHA3_RATE		72		// bytes of the block (SHA3-512)
+#define SHA3_DIGEST		64		// bytes of the digest
+#define SHA3_MAX_LANES	8		// rows at once (max)
+
+static const uint64_t sha3_rc[24] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+	0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+	0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+	0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+	0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+	0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+static const int sha3_pi [25] = { 0, 10, 20, 5, 15, 16, 1, 11, 21, 6, 7, 17, 2, 12, 22, 23, 8, 18, 3, 13, 14, 24, 9, 19, 4 };
+static const int sha3_rho[25] = { 0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14 };
+
+// Keccak-f[1600]: the same rounds for a word and for a vector of words (one word per row)
+#define SHA3_PERMUTE(T, XOR, ANDN, ROL, RC)												\
+	for (int round = 0; round < 24; round++) {											\
+		T C[5], D[5], B[25];															\
+		for (int x = 0; x < 5; x++)														\
+			C[x] = XOR(XOR(XOR(A[x], A[x + 5]), XOR(A[x + 10], A[x + 15])), A[x + 20]);	\
+		for (int x = 0; x < 5; x++)														\
+			D[x] = XOR(C[(x + 4) % 5], ROL(C[(x + 1) % 5], 1));							\
+		for (int i = 0; i < 25; i++)													\
+			B[sha3_pi[i]] = ROL(XOR(A[i], D[i % 5]), sha3_rho[i]);						\
+		for (int y = 0; y < 25; y += 5)													\
+			for (int x = 0; x < 5; x++)													\
+				A[y + x] = XOR(B[y + x], ANDN(B[y + (x + 1) % 5], B[y + (x + 2) % 5]));	\
+		A[0] = XOR(A[0], RC(sha3_rc[round]));											\
+	}
+
+#define SHA3_XOR64(a, b)	((a) ^ (b))
+#define SHA3_ANDN64(a, b)	(~(a) & (b))
+#define SHA3_ROL64(a, n)	(((n) == 0) ? (a) : (((a) << (n)) | ((a) >> (64 - (n)))))
+#define SHA3_RC64(c)		(c)
+
+//-------------------------------------------------------------------------------------------------
+inline uint64_t Sha3Load64 (const unsigned char* p)		// little-endian word
+{
+	uint64_t w = 0;
+	for (int i = 7; i >= 0; i--)
+		w = (w << 8) | p[i];
+	return w;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline int Sha3Blocks (size_t len)		// blocks of the message with padding
+{
+	return (int)(len / SHA3_RATE) + 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+// block b of the message (the last block is padded: 0x06 ... 0x80)
+inline const unsigned char* Sha3Block (const unsigned char* data, size_t len, int b, unsigned char* pad)
+{
+	size_t pos = (size_t)b * SHA3_RATE;
+	if (pos + SHA3_RATE <= len)
+		return data + pos;
+
+	size_t rest = len - pos;	// the last block
+	memset(pad, 0, SHA3_RATE);
+	if (rest > 0)
+		memcpy(pad, data + pos, rest);
+	pad[rest]          ^= 0x06;
+	pad[SHA3_RATE - 1] ^= 0x80;
+	return pad;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline void Sha3_512 (const unsigned char* data, size_t len, unsigned char* out)	// one message
+{
+	uint64_t A[25];
+	memset(A, 0, sizeof(A));
+
+	unsigned char pad[SHA3_RATE];
+	int nb = Sha3Blocks(len);
+	for (int b = 0; b < nb; b++) {
+		const unsigned char* p = Sha3Block(data, len, b, pad);
+		for (int i = 0; i < SHA3_RATE / 8; i++)
+			A[i] ^= Sha3Load64(p + 8 * i);
+		SHA3_PERMUTE(uint64_t, SHA3_XOR64, SHA3_ANDN64, SHA3_ROL64, SHA3_RC64)
+	}
+	for (int i = 0; i < SHA3_DIGEST / 8; i++)
+		for (int k = 0; k < 8; k++)
+			out[8 * i + k] = (unsigned char)(A[i] >> (8 * k));
+}
+
+#ifdef SHA3_X86
+
+//-------------------------------------------------------------------------------------------------
+// the words of the lanes are gathered into the vectors; a lane is saved after its last block
+#define SHA3_MULTI(LANES, T, LOADW, XOR, ANDN, ROL, RC)										\
+	T A[25];																				\
+	for (int i = 0; i < 25; i++) A[i] = RC(0);												\
+	unsigned char pad[LANES][SHA3_RATE];													\
+	int nb[LANES], maxb = 0;																\
+	for (int l = 0; l < LANES; l++) {														\
+		nb[l] = Sha3Blocks(len[l]);															\
+		if (nb[l] > maxb) maxb = nb[l];														\
+	}																						\
+	for (int b = 0; b < maxb; b++) {														\
+		const unsigned char* p[LANES];														\
+		for (int l = 0; l < LANES; l++)														\
+			p[l] = (b < nb[l]) ? Sha3Block(data[l], len[l], b, pad[l]) : 0;				\
+		for (int i = 0; i < SHA3_RATE / 8; i++) {											\
+			uint64_t w[LANES];																\
+			for (int l = 0; l < LANES; l++)													\
+				w[l] = (p[l] != 0) ? Sha3Load64(p[l] + 8 * i) : 0;							\
+			A[i] = XOR(A[i], LOADW(w));														\
+		}																					\
+		SHA3_PERMUTE(T, XOR, ANDN, ROL, RC)													\
+		for (int l = 0; l < LANES; l++) {													\
+			if (nb[l] != b + 1) continue;													\
+			for (int i = 0; i < SHA3_DIGEST / 8; i++) {										\
+				uint64_t w[LANES];															\
+				memcpy(w, &A[i], sizeof(w));												\
+				for (int k = 0; k < 8; k++)													\
+					out[l][8 * i + k] = (unsigned char)(w[l] >> (8 * k));					\
+			}																				\
+		}																					\
+	}
+
+#define SHA3_XOR256(a, b)	_mm256_xor_si256((a), (b))
+#define SHA3_ANDN256(a, b)	_mm256_andnot_si256((a), (b))
+#define SHA3_ROL256(a, n)	_mm256_or_si256(_mm256_sll_epi64((a), _mm_cvtsi32_si128(n)), _mm256_srl_epi64((a), _mm_cvtsi32_si128(64 - (n))))
+#define SHA3_RC256(c)		_mm256_set1_epi64x((long long)(c))
+#define SHA3_LOAD256(w)		_mm256_loadu_si256((const __m256i*)(w))
+
+SHA3_TARGET("avx2")
+inline void Sha3_512x4 (const unsigned char* const* data, const size_t* len, unsigned char* const* out)
+{
+	SHA3_MULTI(4, __m256i, SHA3_LOAD256, SHA3_XOR256, SHA3_ANDN256, SHA3_ROL256, SHA3_RC256)
+}
+
+#define SHA3_XOR512(a, b)	_mm512_xor_si512((a), (b))
+#define SHA3_ANDN512(a, b)	_mm512_andnot_si512((a), (b))
+#define SHA3_ROL512(a, n)	_mm512_rolv_epi64((a), _mm512_set1_epi64(n))
+#define SHA3_RC512(c)		_mm512_set1_epi64((long long)(c))
+#define SHA3_LOAD512(w)		_mm512_loadu_si512((const void*)(w))
+
+SHA3_TARGET("avx512f")
+inline void Sha3_512x8 (const unsigned char* const* data, const size_t* len, unsigned char* const* out)
+{
+	SHA3_MULTI(8, __m512i, SHA3_LOAD512, SHA3_XOR512, SHA3_ANDN512, SHA3_ROL512, SHA3_RC512)
+}
+
+//-------------------------------------------------------------------------------------------------
+inline int Sha3CpuLanes ()		// rows at once for this CPU
+{
+#ifdef _MSC_VER
+	int r[4];
+	__cpuid(r, 0);
+	if (r[0] < 7)								return 1;
+	__cpuid(r, 1);
+	bool bOsAvx = (r[2] & (1 << 27)) != 0 && (r[2] & (1 << 28)) != 0;	// osxsave, avx
+	if (bOsAvx == false)						return 1;
+	unsigned long long xcr = _xgetbv(0);
+	__cpuidex(r, 7, 0);
+	if ((xcr & 0xE6) == 0xE6 && (r[1] & (1 << 16)) != 0)	return 8;	// zmm state, avx512f
+	if ((xcr & 0x06) == 0x06 && (r[1] & (1 <<  5)) != 0)	return 4;	// ymm state, avx2
+	return 1;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))		return 8;
+	if (__builtin_cpu_supports("avx2"))			return 4;
+	return 1;
+#endif
+}
+
+#else
+inline int Sha3CpuLanes () { return 1; }
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// SHA3-512 of n messages. lanes: 0 - by CPU, 1 - scalar, 4 - AVX2, 8 - AVX-512
+inline void Sha3_512_Multi (const unsigned char* const* data, const size_t* len, unsigned char* const* out, int n, int lanes = 0)
+{
+	static const int cpuLanes = Sha3CpuLanes();
+	if (lanes <= 0 || lanes > cpuLanes)
+		lanes = cpuLanes;
+
+	int k = 0;
+#ifdef SHA3_X86
+	for (; lanes == 8 && k + 8 <= n; k += 8)	Sha3_512x8(data + k, len + k, out + k);
+	for (; lanes >= 4 && k + 4 <= n; k += 4)	Sha3_512x4(data + k, len + k, out + k);
+#endif
+	for (; k < n; k++)							Sha3_512(data[k], len[k], out[k]);
+}